@@ -0,0 +1,120 @@
+/// \file AudioFormat.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Audio file parsing and sample decoding for the MusicPlayer.
+
+#include "AudioFormat.hpp"
+
+#include <cstring>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Read a little-endian integer of the given number of bytes.
+std::uint32_t
+readLE_(const std::uint8_t* data, int bytes)
+{
+  std::uint32_t value = 0;
+  for (int i = bytes - 1; i >= 0; --i)
+    value = value << 8 | data[i];
+  return value;
+}
+
+/// \brief Check if a parsed format is one the player can decode.
+bool
+supported_(const rb::WavFormat& format)
+{
+  if (format.rate <= 0)
+    return false;
+  switch (format.tag) {
+    case rb::kWavPcm:
+      return (format.bits == 8 || format.bits == 16) &&
+             (format.channels == 1 || format.channels == 2);
+
+    case rb::kWavImaAdpcm:
+      return format.bits == 4 && format.channels == 1 &&
+             format.block > rb::ImaAdpcm::kHeaderSize;
+
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+bool
+parseWav(std::FILE* file, long size, WavFormat& format)
+{
+  std::uint8_t header[16];
+  if (
+    size < 12 || std::fread(header, 1, 12, file) != 12 ||
+    std::memcmp(header, "RIFF", 4) != 0 ||
+    std::memcmp(header + 8, "WAVE", 4) != 0)
+    return false;
+
+  bool have_fmt = false;
+  long pos      = 12;
+  while (pos + 8 <= size) {
+    if (std::fread(header, 1, 8, file) != 8)
+      return false;
+    const std::uint32_t chunk = readLE_(header + 4, 4);
+    pos += 8;
+
+    if (std::memcmp(header, "data", 4) == 0) {
+      if (!have_fmt)
+        return false;
+      format.size = std::min<std::uint32_t>(chunk, size - pos);
+      // Drop any trailing partial frame. A partial ADPCM block is still good.
+      if (format.tag == kWavPcm)
+        format.size -= format.size % format.block;
+      return true;
+    }
+    if (chunk > static_cast<std::uint32_t>(size - pos))
+      return false;
+
+    long skip = chunk + (chunk & 1); // Chunks are padded to even sizes.
+    if (std::memcmp(header, "fmt ", 4) == 0) {
+      if (chunk < 16 || std::fread(header, 1, 16, file) != 16)
+        return false;
+      format.tag      = readLE_(header, 2);
+      format.channels = readLE_(header + 2, 2);
+      format.rate     = readLE_(header + 4, 4);
+      format.block    = readLE_(header + 12, 2);
+      format.bits     = readLE_(header + 14, 2);
+      if (!supported_(format))
+        return false;
+      if (format.tag == kWavPcm)
+        format.block = format.bits / 8 * format.channels;
+      have_fmt = true;
+      skip -= 16;
+    }
+    if (std::fseek(file, skip, SEEK_CUR))
+      return false;
+    pos += chunk + (chunk & 1);
+  }
+  return false;
+}
+
+// clang-format off
+const std::int16_t ImaAdpcm::kSteps[89] = {
+      7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+     19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+     50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+    337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+    876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+   2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+   5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const std::int8_t ImaAdpcm::kIndexSteps[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+// clang-format on
+
+} // namespace rb
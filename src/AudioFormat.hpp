@@ -0,0 +1,170 @@
+/// \file AudioFormat.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Audio file parsing and sample decoding for the MusicPlayer.
+///
+/// \details Everything here is plain C++ with no dependency on mbed or the
+/// hardware, so the decode path can be built and exercised on a host.
+
+#ifndef RB_AUDIO_FORMAT_HPP
+#define RB_AUDIO_FORMAT_HPP
+
+#ifndef __cplusplus
+#error "AudioFormat.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief WAVE format tag of integer PCM.
+constexpr int kWavPcm = 0x0001;
+
+/// \brief WAVE format tag of IMA ADPCM.
+constexpr int kWavImaAdpcm = 0x0011;
+
+/// \brief Format of the sample data in a RIFF/WAVE file.
+struct WavFormat
+{
+  int  tag;      // WAVE format tag.
+  int  rate;     // Samples per second.
+  int  bits;     // Bits per sample.
+  int  channels;
+  int  block;    // Bytes per frame, or per block of compressed frames.
+  long size;     // Bytes of sample data.
+};
+
+/// \brief Parse a RIFF/WAVE header and skip to the sample data.
+///
+/// \param size Size of the file. Bounds the chunk walk, so a bad header cannot
+/// run off the end of a file packed in a larger one.
+///
+/// \return true if the file holds 8-bit or 16-bit PCM of one or two channels,
+/// or mono IMA ADPCM. The format is filled in as far as it was parsed either
+/// way.
+bool
+parseWav(std::FILE* file, long size, WavFormat& format);
+
+/// \brief Convert a signed 16-bit sample to a DAC sample, keeping the full
+/// 10-bit resolution of the DAC (bits 15:6).
+inline std::uint16_t
+dacSample(int value)
+{
+  return static_cast<std::uint16_t>((value + 0x8000) & 0xFFC0);
+}
+
+/// \brief Convert PCM frames to DAC samples in place, mixing channels down to
+/// mono.
+///
+/// \tparam Bits 8 for unsigned, or 16 for signed little-endian samples.
+/// \tparam Channels Number of interleaved channels.
+/// \param buffer Holds count raw frames on input, and count samples on output.
+template<int Bits, int Channels, typename Sample>
+void
+convertPcm(Sample* buffer, int count);
+
+/// \brief Fixed-point IMA ADPCM decoder for one channel.
+class ImaAdpcm
+{
+ public:
+  /// \brief Size of the header starting each block: the first sample as s16,
+  /// the step index, and a reserved byte.
+  static constexpr int kHeaderSize = 4;
+
+  /// \brief Start a block.
+  ///
+  /// \return The first sample of the block, as a DAC sample.
+  std::uint16_t header(const std::uint8_t* header)
+  {
+    _predictor = static_cast<std::int16_t>(header[0] | header[1] << 8);
+    _index     = std::min<int>(header[2], 88);
+    return dacSample(_predictor);
+  }
+
+  /// \brief Decode one nibble.
+  ///
+  /// \return The decoded sample, as a DAC sample.
+  std::uint16_t nibble(int nibble);
+
+  /// \brief Get the last decoded sample at full resolution, signed.
+  int predictor() const { return _predictor; }
+
+ private:
+  static const std::int16_t kSteps[89];
+  static const std::int8_t  kIndexSteps[8];
+
+  int _predictor = 0;
+  int _index     = 0;
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+
+namespace detail {
+
+/// \brief Decode one PCM frame into a DAC sample.
+template<int Bits, int Channels>
+inline std::uint16_t
+pcmFrame(const std::uint8_t* frame)
+{
+  int acc = 0;
+  for (int c = 0; c < Channels; ++c) {
+    if (Bits == 8)
+      acc += (frame[c] << 8) - 0x8000;
+    else
+      acc += static_cast<std::int16_t>(frame[2 * c] | frame[2 * c + 1] << 8);
+  }
+  return dacSample(acc / Channels);
+}
+
+} // namespace detail
+
+template<int Bits, int Channels, typename Sample>
+void
+convertPcm(Sample* buffer, int count)
+{
+  constexpr int kFrame = Bits / 8 * Channels;
+
+  // Samples narrower than frames are written ahead of the frames left to read,
+  // wider ones behind them.
+  const std::uint8_t* raw = reinterpret_cast<const std::uint8_t*>(buffer);
+  if (kFrame < static_cast<int>(sizeof(Sample))) {
+    for (int i = count - 1; i >= 0; --i)
+      buffer[i] = detail::pcmFrame<Bits, Channels>(raw + i * kFrame);
+  } else {
+    for (int i = 0; i < count; ++i)
+      buffer[i] = detail::pcmFrame<Bits, Channels>(raw + i * kFrame);
+  }
+}
+
+inline std::uint16_t
+ImaAdpcm::nibble(int nibble)
+{
+  const int step = kSteps[_index];
+
+  int diff = step >> 3;
+  if (nibble & 4)
+    diff += step;
+  if (nibble & 2)
+    diff += step >> 1;
+  if (nibble & 1)
+    diff += step >> 2;
+
+  _predictor += (nibble & 8) ? -diff : diff;
+  _predictor = std::min(std::max(_predictor, -0x8000), 0x7FFF);
+  _index += kIndexSteps[nibble & 7];
+  _index = std::min(std::max(_index, 0), 88);
+  return dacSample(_predictor);
+}
+
+} // namespace rb
+
+#endif // RB_AUDIO_FORMAT_HPP
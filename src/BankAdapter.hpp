@@ -0,0 +1,122 @@
+/// \file BankAdapter.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Adaptation of the MusicPlayer's bank size to the measured refill
+/// time and to the voices starved by the card.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// AudioFormat.hpp.
+
+#ifndef RB_BANK_ADAPTER_HPP
+#define RB_BANK_ADAPTER_HPP
+
+#ifndef __cplusplus
+#error "BankAdapter.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <algorithm>
+#include <cstdint>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Grows or shrinks the banks of a ring from the time taken by its
+/// refills, and from the voices starved in them.
+///
+/// Over each window, the slowest refill is held against the time the ring
+/// covers ahead of the DAC. The banks double when it takes more than half of
+/// it, and halve when it takes less than an eighth, which leaves room for the
+/// halved ring without bouncing back.
+///
+/// A refill that starved a voice, as the card fell behind by more than the
+/// ring covers, doubles the banks at once. The ring then covers twice as long
+/// a hold-up of the card. Since such hold-ups come and go, the banks are not
+/// shrunk again for kHold windows after.
+class BankAdapter
+{
+ public:
+  /// \brief Number of refills the bank length is judged over.
+  static constexpr int kWindow = 16;
+
+  /// \brief Number of windows the banks are kept from shrinking for after a
+  /// voice was starved.
+  static constexpr int kHold = 64;
+
+  /// \brief Constructor. The banks start out at their largest.
+  ///
+  /// \param count Number of banks in the ring.
+  /// \param min_len Smallest number of samples in a bank.
+  /// \param max_len Largest number of samples in a bank.
+  BankAdapter(int count, int min_len, int max_len) :
+      _count(count),
+      _min(min_len),
+      _max(max_len),
+      _len(max_len)
+  {
+  }
+
+  /// \brief Get the number of samples in each bank being mixed.
+  int length() const { return _len; }
+
+  /// \brief Start a new window, keeping the length.
+  void restart()
+  {
+    _worst   = 0;
+    _refills = 0;
+  }
+
+  /// \brief Record the outcome of a refill.
+  ///
+  /// \param cycles Time of the refill.
+  /// \param sample_cycles Time the DAC takes per sample, in the same unit.
+  /// \param starved Whether a voice ran out of data in the refill.
+  void record(std::uint32_t cycles, std::uint32_t sample_cycles, bool starved);
+
+ private:
+  int           _count;
+  int           _min;
+  int           _max;
+  int           _len;
+  std::uint32_t _worst   = 0; // Slowest refill of the current window.
+  int           _refills = 0; // Refills of the current window so far.
+  int           _hold    = 0; // Windows left before the banks may shrink.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+
+inline void
+BankAdapter::record(
+  std::uint32_t cycles,
+  std::uint32_t sample_cycles,
+  bool          starved)
+{
+  if (starved) {
+    _len  = std::min(2 * _len, _max);
+    _hold = kHold;
+    restart();
+    return;
+  }
+  _worst = std::max(_worst, cycles);
+  if (++_refills < kWindow)
+    return;
+
+  const std::uint64_t ring =
+    static_cast<std::uint64_t>(_count - 1) * _len * sample_cycles;
+  if (2 * static_cast<std::uint64_t>(_worst) > ring)
+    _len = std::min(2 * _len, _max);
+  else if (_hold > 0)
+    --_hold;
+  else if (8 * static_cast<std::uint64_t>(_worst) < ring)
+    _len = std::max(_len / 2, _min);
+  restart();
+}
+
+} // namespace rb
+
+#endif // RB_BANK_ADAPTER_HPP
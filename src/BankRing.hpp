@@ -0,0 +1,102 @@
+/// \file BankRing.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Rotation of the MusicPlayer's ring of banks, mixed ahead of the DMA
+/// that plays them.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// BankAdapter.hpp, so that the simulator of the player turns the ring with it
+/// too.
+
+#ifndef RB_BANK_RING_HPP
+#define RB_BANK_RING_HPP
+
+#ifndef __cplusplus
+#error "BankRing.hpp is a cxx-only header."
+#endif // __cplusplus
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Indices of a ring of banks. Banks [consumed, produced) hold valid
+/// data, and bank consumed is the one being played.
+///
+/// The indices run on and wrap around, and bank i is held in slot i % count.
+/// The DMA never stops, so once it gets to a bank that was not mixed yet, it
+/// plays the stale data left in its slot.
+class BankRing
+{
+ public:
+  /// \brief Constructor. No bank holds data.
+  explicit BankRing(int count) : _count(count) {}
+
+  /// \brief Get the index of the bank being played.
+  unsigned int consumed() const { return _consumed; }
+
+  /// \brief Get the index of the next bank to mix.
+  unsigned int produced() const { return _produced; }
+
+  /// \brief Get the slot of the ring holding a bank.
+  int slot(unsigned int bank) const { return bank % _count; }
+
+  /// \brief Get the number of banks mixed ahead of the DMA, the one being
+  /// played included. 0 or less once the DMA has caught up.
+  int ahead() const { return static_cast<int>(_produced - _consumed); }
+
+  /// \brief Check if there is no slot to mix a bank into.
+  bool full() const { return ahead() >= _count; }
+
+  /// \brief Move on to the next bank, as the DMA does. Called from the bank
+  /// interrupt.
+  void consume() { _consumed = _consumed + 1; }
+
+  /// \brief Skip to the bank after the one being played if the DMA has caught
+  /// up, and is replaying a stale bank.
+  ///
+  /// \return true on such an underrun.
+  bool resync()
+  {
+    if (ahead() > 0)
+      return false;
+    _produced = _consumed + 1;
+    return true;
+  }
+
+  /// \brief Check if the bank being mixed is due: the DMA plays it next, once
+  /// the bank it is playing ends. The mix of a bank that is due has a bank
+  /// period left, and cannot wait on anything any longer.
+  bool due() const { return ahead() <= 1; }
+
+  /// \brief Check if the DMA got to the bank being mixed before it was done.
+  bool late() const { return static_cast<int>(_consumed - _produced) >= 0; }
+
+  /// \brief Hand the bank being mixed over to the DMA.
+  void produce() { ++_produced; }
+
+  /// \brief Drop the banks queued ahead of the DMA, so that they are mixed
+  /// again. The bank after the one playing is kept, since the DMA may be
+  /// loading it.
+  ///
+  /// \return true if any bank was dropped.
+  bool rewind()
+  {
+    const unsigned int keep = _consumed + 2;
+    if (static_cast<int>(_produced - keep) <= 0)
+      return false;
+    _produced = keep;
+    return true;
+  }
+
+ private:
+  int                   _count;
+  volatile unsigned int _consumed = 0; // Advanced by the bank interrupt.
+  unsigned int          _produced = 0;
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_BANK_RING_HPP
@@ -0,0 +1,246 @@
+/// \file CachedBlockDevice.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Read cache and read-ahead in front of a block device.
+
+#include "CachedBlockDevice.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+CachedBlockDevice::CachedBlockDevice(mbed::BlockDevice* device) :
+  _device(device), _stats(), _slots()
+{
+}
+
+CachedBlockDevice::Stats
+CachedBlockDevice::stats() const
+{
+  _mutex.lock();
+  const Stats stats = _stats;
+  _mutex.unlock();
+  return stats;
+}
+
+void
+CachedBlockDevice::resetStats()
+{
+  _mutex.lock();
+  _stats = Stats();
+  _mutex.unlock();
+}
+
+int
+CachedBlockDevice::init()
+{
+  _mutex.lock();
+  invalidate(0, _device->size());
+  const int err = _device->init();
+  _mutex.unlock();
+  return err;
+}
+
+int
+CachedBlockDevice::deinit()
+{
+  _mutex.lock();
+  invalidate(0, _device->size());
+  const int err = _device->deinit();
+  _mutex.unlock();
+  return err;
+}
+
+int
+CachedBlockDevice::sync()
+{
+  return _device->sync();
+}
+
+int
+CachedBlockDevice::read(void* buffer, bd_addr_t addr, bd_size_t size)
+{
+  // Only whole sectors are cached.
+  if (addr % kSectorSize != 0 || size % kSectorSize != 0) {
+    _mutex.lock();
+    ++_stats.device_reads;
+    _mutex.unlock();
+    return _device->read(buffer, addr, size);
+  }
+
+  _mutex.lock();
+  std::uint8_t* out    = static_cast<std::uint8_t*>(buffer);
+  std::uint32_t sector = addr / kSectorSize;
+  std::uint32_t count  = size / kSectorSize;
+  while (count > 0) {
+    int n = 1;
+    if (lookup(sector, out))
+      ++_stats.hits;
+    else if ((n = fetch(sector, count, out)) < 0)
+      break;
+    sector += n;
+    count -= n;
+    out += n * kSectorSize;
+    _next = sector;
+  }
+  _mutex.unlock();
+  return count == 0 ? 0 : BD_ERROR_DEVICE_ERROR;
+}
+
+int
+CachedBlockDevice::program(const void* buffer, bd_addr_t addr, bd_size_t size)
+{
+  _mutex.lock();
+  invalidate(addr, size);
+  const int err = _device->program(buffer, addr, size);
+  _mutex.unlock();
+  return err;
+}
+
+int
+CachedBlockDevice::erase(bd_addr_t addr, bd_size_t size)
+{
+  _mutex.lock();
+  invalidate(addr, size);
+  const int err = _device->erase(addr, size);
+  _mutex.unlock();
+  return err;
+}
+
+int
+CachedBlockDevice::trim(bd_addr_t addr, bd_size_t size)
+{
+  _mutex.lock();
+  invalidate(addr, size);
+  const int err = _device->trim(addr, size);
+  _mutex.unlock();
+  return err;
+}
+
+bd_size_t
+CachedBlockDevice::get_read_size() const
+{
+  return _device->get_read_size();
+}
+
+bd_size_t
+CachedBlockDevice::get_program_size() const
+{
+  return _device->get_program_size();
+}
+
+bd_size_t
+CachedBlockDevice::get_erase_size() const
+{
+  return _device->get_erase_size();
+}
+
+bd_size_t
+CachedBlockDevice::get_erase_size(bd_addr_t addr) const
+{
+  return _device->get_erase_size(addr);
+}
+
+int
+CachedBlockDevice::get_erase_value() const
+{
+  return _device->get_erase_value();
+}
+
+bd_size_t
+CachedBlockDevice::size() const
+{
+  return _device->size();
+}
+
+const char*
+CachedBlockDevice::get_type() const
+{
+  return _device->get_type();
+}
+
+bool
+CachedBlockDevice::lookup(std::uint32_t sector, std::uint8_t* out)
+{
+  if (sector - _window_start < _window_count) {
+    std::memcpy(
+      out, _window + (sector - _window_start) * kSectorSize, kSectorSize);
+    return true;
+  }
+
+  for (Slot& slot : _slots) {
+    if (slot.used != 0 && slot.sector == sector) {
+      slot.used = ++_tick;
+      std::memcpy(out, _cache[&slot - _slots], kSectorSize);
+      return true;
+    }
+  }
+  return false;
+}
+
+int
+CachedBlockDevice::fetch(
+  std::uint32_t sector,
+  std::uint32_t count,
+  std::uint8_t* out)
+{
+  const bd_addr_t addr = static_cast<bd_addr_t>(sector) * kSectorSize;
+  ++_stats.device_reads;
+
+  // Several sectors are already a multi-block read, and reading them through
+  // the window would only add a copy, so they go straight into the buffer.
+  if (count > 1) {
+    if (_device->read(out, addr, count * kSectorSize))
+      return -1;
+    _stats.misses += count;
+    return count;
+  }
+
+  if (sector == _next) {
+    const std::uint32_t left =
+      static_cast<std::uint32_t>(_device->size() / kSectorSize) - sector;
+    const std::uint32_t n = std::min<std::uint32_t>(kWindowSectors, left);
+    _window_count         = 0;
+    if (_device->read(_window, addr, n * kSectorSize))
+      return -1;
+    _window_start = sector;
+    _window_count = n;
+    count         = std::min(count, n);
+    std::memcpy(out, _window, count * kSectorSize);
+    _stats.misses += count;
+    _stats.read_ahead += n - count;
+    return count;
+  }
+
+  // A single sector out of the way, most likely of the FAT or a directory.
+  Slot* slot = std::min_element(
+    _slots, _slots + kCacheSectors, [](const Slot& a, const Slot& b) {
+      return a.used < b.used;
+    });
+  slot->used = 0;
+  if (_device->read(_cache[slot - _slots], addr, kSectorSize))
+    return -1;
+  slot->sector = sector;
+  slot->used   = ++_tick;
+  std::memcpy(out, _cache[slot - _slots], kSectorSize);
+  ++_stats.misses;
+  return 1;
+}
+
+void
+CachedBlockDevice::invalidate(bd_addr_t addr, bd_size_t size)
+{
+  const bd_addr_t first = addr / kSectorSize;
+  const bd_addr_t end   = (addr + size + kSectorSize - 1) / kSectorSize;
+  if (_window_start < end && first < _window_start + _window_count)
+    _window_count = 0;
+  for (Slot& slot : _slots)
+    if (slot.sector >= first && slot.sector < end)
+      slot.used = 0;
+}
+
+} // namespace rb
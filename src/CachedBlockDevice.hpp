@@ -0,0 +1,126 @@
+/// \file CachedBlockDevice.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Read cache and read-ahead in front of a block device.
+
+#ifndef RB_CACHED_BLOCK_DEVICE_HPP
+#define RB_CACHED_BLOCK_DEVICE_HPP
+
+#ifndef __cplusplus
+#error "CachedBlockDevice.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+
+#include <BlockDevice.h>
+#include <PlatformMutex.h>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Block device adapter that batches and caches reads of another one.
+///
+/// Reads are served from two places before going to the device:
+///
+/// - A read-ahead window. A single sector read that follows on from the
+///   previous read fills the window with the sectors after it in one
+///   multi-block read, so a file read a sector at a time costs one command per
+///   window rather than one per sector.
+/// - A few single sectors, kept least recently used. Reads that jump around,
+///   like those of the FAT and directories, land here.
+///
+/// Reads of several sectors go straight into the caller's buffer in one
+/// multi-block read, so whole sectors of a file are never copied. Writes go
+/// through to the device, and drop any cached copy of the sectors they touch.
+///
+/// Only depends on the BlockDevice interface, so it can sit in front of any
+/// device, such as a HeapBlockDevice with added latency.
+class CachedBlockDevice : public mbed::BlockDevice
+{
+ public:
+  /// \brief Size of a sector in bytes. The read size of the device must divide
+  /// it.
+  static constexpr int kSectorSize = 512;
+
+  /// \brief Number of single sectors cached.
+  static constexpr int kCacheSectors = 4;
+
+  /// \brief Number of sectors in the read-ahead window.
+  static constexpr int kWindowSectors = 8;
+
+  /// \brief Cache statistics, in sectors unless noted.
+  struct Stats
+  {
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int read_ahead;   // Read ahead into the window.
+    unsigned int device_reads; // Read commands sent to the device.
+  };
+
+  /// \brief Constructor.
+  ///
+  /// \param device Device to cache. Must outlive the adapter.
+  explicit CachedBlockDevice(mbed::BlockDevice* device);
+
+  /// \brief Get the statistics since the last reset.
+  Stats stats() const;
+
+  /// \brief Reset the statistics.
+  void resetStats();
+
+  int init() override;
+  int deinit() override;
+  int sync() override;
+  int read(void* buffer, bd_addr_t addr, bd_size_t size) override;
+  int program(const void* buffer, bd_addr_t addr, bd_size_t size) override;
+  int erase(bd_addr_t addr, bd_size_t size) override;
+  int trim(bd_addr_t addr, bd_size_t size) override;
+
+  bd_size_t   get_read_size() const override;
+  bd_size_t   get_program_size() const override;
+  bd_size_t   get_erase_size() const override;
+  bd_size_t   get_erase_size(bd_addr_t addr) const override;
+  int         get_erase_value() const override;
+  bd_size_t   size() const override;
+  const char* get_type() const override;
+
+ private:
+  /// \brief A cached sector.
+  struct Slot
+  {
+    std::uint32_t sector;
+    std::uint32_t used; // Tick of the last use, 0 if empty.
+  };
+
+  /// \brief Copy a sector out of the cache or the window, if there.
+  bool lookup(std::uint32_t sector, std::uint8_t* out);
+
+  /// \brief Read sectors that were not cached.
+  ///
+  /// \return The number of sectors read, or a negative error code.
+  int fetch(std::uint32_t sector, std::uint32_t count, std::uint8_t* out);
+
+  /// \brief Drop cached copies of a range of sectors.
+  void invalidate(bd_addr_t addr, bd_size_t size);
+
+  mbed::BlockDevice*    _device;
+  mutable PlatformMutex _mutex;
+  Stats                 _stats;
+
+  std::uint32_t _tick = 0;
+  Slot          _slots[kCacheSectors];
+  std::uint8_t  _cache[kCacheSectors][kSectorSize];
+
+  std::uint32_t _next         = 0; // Sector after the last one read.
+  std::uint32_t _window_start = 0;
+  std::uint32_t _window_count = 0; // Sectors held in the window, 0 if empty.
+  std::uint8_t  _window[kWindowSectors * kSectorSize];
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_CACHED_BLOCK_DEVICE_HPP
@@ -0,0 +1,202 @@
+/// \file ClipCache.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief RAM-resident LRU cache of small audio clips.
+
+#include "ClipCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+ClipCache::ClipCache(std::uint8_t* storage, std::size_t size) :
+    _storage(storage),
+    _block_count(std::min<std::size_t>(size / kBlockSize, kNoBlock)),
+    _free(kNoBlock),
+    _free_count(0),
+    _clock(0),
+    _hits(0),
+    _misses(0),
+    _evictions(0)
+{
+  for (Clip& c : _clips) {
+    c.first = kNoBlock;
+    c.ready = false;
+    c.pins  = 0;
+  }
+  for (int i = _block_count - 1; i >= 0; --i) {
+    _next[i] = _free;
+    _free    = i;
+    ++_free_count;
+  }
+}
+
+int
+ClipCache::acquire(const char* name)
+{
+  for (int i = 0; i < kMaxClips; ++i) {
+    Clip& c = _clips[i];
+    if (c.ready && std::strcmp(c.name, name) == 0) {
+      ++c.pins;
+      c.last_use = ++_clock;
+      ++_hits;
+      return i;
+    }
+  }
+  ++_misses;
+  return -1;
+}
+
+int
+ClipCache::insert(const char* name, std::size_t size)
+{
+  const int needed = (size + kBlockSize - 1) / kBlockSize;
+  if (std::strlen(name) >= kNameSize || needed > _block_count)
+    return -1;
+
+  // Evict least recently used clips until there is a free slot and enough free
+  // blocks.
+  int slot = -1;
+  while (true) {
+    int lru = -1;
+    slot    = -1;
+    for (int i = 0; i < kMaxClips; ++i) {
+      const Clip& c = _clips[i];
+      if (c.first == kNoBlock && c.pins == 0) {
+        if (slot < 0)
+          slot = i;
+      } else if (
+        c.ready && c.pins == 0 &&
+        (lru < 0 || c.last_use < _clips[lru].last_use)) {
+        lru = i;
+      }
+    }
+    if (slot >= 0 && _free_count >= needed)
+      break;
+    if (lru < 0)
+      return -1;
+    evict(lru);
+    ++_evictions;
+  }
+
+  Clip& c = _clips[slot];
+  std::strcpy(c.name, name);
+  c.size     = size;
+  c.last_use = ++_clock;
+  c.ready    = false;
+  c.pins     = 1;
+
+  // Take the blocks off the free chain. An empty clip still holds one block so
+  // that the slot reads as used.
+  c.first          = _free;
+  std::uint8_t end = _free;
+  for (int i = 1; i < std::max(needed, 1); ++i)
+    end = _next[end];
+  _free      = _next[end];
+  _next[end] = kNoBlock;
+  _free_count -= std::max(needed, 1);
+
+  return slot;
+}
+
+std::size_t
+ClipCache::writeSpan(int clip, std::size_t offset, std::uint8_t*& span)
+{
+  const Clip& c = _clips[clip];
+  if (offset >= c.size)
+    return 0;
+  span = _storage + block(clip, offset) * kBlockSize + offset % kBlockSize;
+  return std::min(kBlockSize - offset % kBlockSize, c.size - offset);
+}
+
+void
+ClipCache::publish(int clip)
+{
+  _clips[clip].ready = true;
+}
+
+void
+ClipCache::discard(int clip)
+{
+  _clips[clip].pins = 0;
+  evict(clip);
+}
+
+std::size_t
+ClipCache::read(
+  int           clip,
+  std::size_t   offset,
+  std::uint8_t* data,
+  std::size_t   count) const
+{
+  const Clip& c = _clips[clip];
+  if (offset >= c.size)
+    return 0;
+  count = std::min(count, c.size - offset);
+
+  std::uint8_t b    = block(clip, offset);
+  std::size_t  done = 0;
+  while (done < count) {
+    const std::size_t in_block = (offset + done) % kBlockSize;
+    const std::size_t n        = std::min(kBlockSize - in_block, count - done);
+    std::memcpy(data + done, _storage + b * kBlockSize + in_block, n);
+    done += n;
+    b = _next[b];
+  }
+  return done;
+}
+
+void
+ClipCache::release(int clip)
+{
+  --_clips[clip].pins;
+}
+
+ClipCache::Stats
+ClipCache::stats() const
+{
+  return {
+    _hits,
+    _misses,
+    _evictions,
+    (_block_count - _free_count) * kBlockSize};
+}
+
+std::uint8_t
+ClipCache::block(int clip, std::size_t offset) const
+{
+  std::uint8_t b = _clips[clip].first;
+  for (std::size_t i = offset / kBlockSize; i > 0; --i)
+    b = _next[b];
+  return b;
+}
+
+void
+ClipCache::evict(int clip)
+{
+  Clip& c = _clips[clip];
+
+  // Hand the chain back to the free chain.
+  std::uint8_t end = c.first;
+  int          n   = 1;
+  for (; _next[end] != kNoBlock; end = _next[end])
+    ++n;
+  _next[end] = _free;
+  _free      = c.first;
+  _free_count += n;
+
+  c.first = kNoBlock;
+  c.ready = false;
+}
+
+} // namespace rb
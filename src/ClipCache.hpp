@@ -0,0 +1,141 @@
+/// \file ClipCache.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief RAM-resident LRU cache of small audio clips.
+
+#ifndef RB_CLIP_CACHE_HPP
+#define RB_CLIP_CACHE_HPP
+
+#ifndef __cplusplus
+#error "ClipCache.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief LRU cache of clip data with a fixed byte budget.
+///
+/// The storage is split into fixed-size blocks, and each clip holds a chain of
+/// blocks, so clips of any size can be evicted and replaced without
+/// fragmenting the budget. Clips are looked up by name.
+///
+/// A clip is pinned while it is in use and is never evicted while pinned. One
+/// thread (the owner) looks up, inserts and fills clips. Any thread may read
+/// and release a clip pinned for it, which is how a clip is handed over to the
+/// audio thread.
+class ClipCache
+{
+ public:
+  /// \brief Size of a storage block in bytes.
+  static constexpr std::size_t kBlockSize = 256;
+
+  /// \brief Maximum number of clips held at once.
+  static constexpr int kMaxClips = 16;
+
+  /// \brief Maximum length of a clip name, including the terminator.
+  static constexpr std::size_t kNameSize = 48;
+
+  /// \brief Cache statistics.
+  struct Stats
+  {
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int evictions;
+    std::size_t  used; // Bytes of storage held by clips.
+  };
+
+  /// \brief Constructor.
+  ///
+  /// \param storage Backing storage for the clip data.
+  /// \param size Size of the storage in bytes. Rounded down to whole blocks, of
+  /// which there can be at most 255.
+  ClipCache(std::uint8_t* storage, std::size_t size);
+
+  /// \brief Capacity of the cache in bytes.
+  std::size_t capacity() const { return _block_count * kBlockSize; }
+
+  /// \brief Look up a clip and pin it. Owner only.
+  ///
+  /// \return The clip id, or -1 on a miss.
+  int acquire(const char* name);
+
+  /// \brief Make room for a clip and pin it, evicting the least recently used
+  /// unpinned clips as needed. Owner only.
+  ///
+  /// The clip is not found by acquire() until it is filled through writeSpan()
+  /// and published with publish().
+  ///
+  /// \return The clip id, or -1 if the clip cannot be cached.
+  int insert(const char* name, std::size_t size);
+
+  /// \brief Get a contiguous writable region of a clip being filled. Owner
+  /// only.
+  ///
+  /// \return The number of bytes that can be written at span.
+  std::size_t writeSpan(int clip, std::size_t offset, std::uint8_t*& span);
+
+  /// \brief Make a filled clip visible to acquire(). Owner only.
+  void publish(int clip);
+
+  /// \brief Drop a clip that could not be filled, and unpin it. Owner only.
+  void discard(int clip);
+
+  /// \brief Copy data out of a pinned clip.
+  ///
+  /// \return The number of bytes read, less than count only at the clip end.
+  std::size_t read(
+    int           clip,
+    std::size_t   offset,
+    std::uint8_t* data,
+    std::size_t   count) const;
+
+  /// \brief Unpin a clip.
+  void release(int clip);
+
+  /// \brief Get the cache statistics.
+  Stats stats() const;
+
+ private:
+  struct Clip
+  {
+    char             name[kNameSize];
+    std::size_t      size;
+    unsigned int     last_use;
+    std::uint8_t     first; // First block, kNoBlock when unused.
+    bool             ready;
+    std::atomic<int> pins;
+  };
+
+  static constexpr std::uint8_t kNoBlock = 0xFF;
+
+  /// \brief Get the block holding a clip offset.
+  std::uint8_t block(int clip, std::size_t offset) const;
+
+  /// \brief Free the blocks of an unpinned clip.
+  void evict(int clip);
+
+  std::uint8_t* const _storage;
+  const int           _block_count;
+
+  Clip         _clips[kMaxClips];
+  std::uint8_t _next[kNoBlock]; // Block chains, kNoBlock terminated.
+  std::uint8_t _free;           // Free block chain.
+  int          _free_count;
+  unsigned int _clock;
+
+  unsigned int _hits;
+  unsigned int _misses;
+  unsigned int _evictions;
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_CLIP_CACHE_HPP
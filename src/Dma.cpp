@@ -0,0 +1,22 @@
+/// \file Dma.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief The GPDMA controller, and which channel each of its users gets.
+
+#include "Dma.hpp"
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+AjK::MODDMA&
+dma()
+{
+  // Constructed on first use, as users may need it during static
+  // initialization.
+  static AjK::MODDMA controller;
+  return controller;
+}
+
+} // namespace rb
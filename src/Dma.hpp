@@ -0,0 +1,45 @@
+/// \file Dma.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief The GPDMA controller, and which channel each of its users gets.
+
+#ifndef RB_DMA_HPP
+#define RB_DMA_HPP
+
+#ifndef __cplusplus
+#error "Dma.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <MODDMA.h>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Get the GPDMA controller.
+///
+/// MODDMA allows a single instance, which owns the DMA interrupt and hands it
+/// out to the callback of each channel, so every user has to share this one.
+AjK::MODDMA&
+dma();
+
+// Channels, from highest to lowest priority. The controller serves the lowest
+// numbered channel first when several are requesting.
+
+/// \brief The DAC bank ring of the MusicPlayer. Highest priority, so that the
+/// audio never waits behind a card transfer.
+constexpr AjK::MODDMA::CHANNELS kDmaAudio = AjK::MODDMA::Channel_0;
+
+/// \brief Receive side of the SD card SPI.
+constexpr AjK::MODDMA::CHANNELS kDmaSdRx = AjK::MODDMA::Channel_6;
+
+/// \brief Transmit side of the SD card SPI. Below the receive side, which it
+/// can never get ahead of by more than the SSP FIFO.
+constexpr AjK::MODDMA::CHANNELS kDmaSdTx = AjK::MODDMA::Channel_7;
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_DMA_HPP
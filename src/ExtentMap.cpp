@@ -0,0 +1,104 @@
+/// \file ExtentMap.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Map of where a file on a FAT volume lies on its block device.
+
+#include "ExtentMap.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <BlockDevice.h>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Bounce buffer for partial sectors.
+std::uint8_t bounce_[rb::ExtentMap::kMaxSectorSize];
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+bool
+ExtentMap::start(
+  mbed::BlockDevice* device,
+  std::uint32_t      sector_size,
+  std::uint32_t      size)
+{
+  clear();
+  _device      = device;
+  _sector_size = sector_size;
+  _size        = size;
+  return sector_size <= kMaxSectorSize &&
+         sector_size % device->get_read_size() == 0;
+}
+
+bool
+ExtentMap::add(std::uint32_t sector, std::uint32_t count)
+{
+  Extent* last = _count ? &_extents[_count - 1] : nullptr;
+  if (last && last->sector + last->count == sector) {
+    last->count += count;
+  } else if (_count < kMaxExtents) {
+    _extents[_count++] = {sector, count};
+  } else {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+std::uint32_t
+ExtentMap::sectors() const
+{
+  std::uint32_t total = 0;
+  for (int i = 0; i < _count; ++i)
+    total += _extents[i].count;
+  return total;
+}
+
+bool
+ExtentMap::read(std::uint32_t pos, void* data, std::size_t n) const
+{
+  if (!mapped() || pos + n > _size)
+    return false;
+
+  std::uint8_t* out   = static_cast<std::uint8_t*>(data);
+  int           e     = 0;
+  std::uint32_t first = 0; // Sector of the file the extent starts at.
+  while (n > 0) {
+    const std::uint32_t sector = pos / _sector_size;
+    const std::uint32_t offset = pos % _sector_size;
+    while (e < _count && sector >= first + _extents[e].count)
+      first += _extents[e++].count;
+    if (e == _count)
+      return false;
+
+    const std::uint32_t run  = first + _extents[e].count - sector;
+    const std::uint32_t lba  = _extents[e].sector + (sector - first);
+    const bd_addr_t     addr = static_cast<bd_addr_t>(lba) * _sector_size;
+    std::size_t         done;
+    if (offset == 0 && n >= _sector_size) {
+      // As many whole sectors as are consecutive, in one multi-block read.
+      done = std::min<std::size_t>(n / _sector_size, run) * _sector_size;
+      if (_device->read(out, addr, done))
+        return false;
+    } else {
+      if (_device->read(bounce_, addr, _sector_size))
+        return false;
+      done = std::min<std::size_t>(_sector_size - offset, n);
+      std::memcpy(out, bounce_ + offset, done);
+    }
+    out += done;
+    pos += done;
+    n -= done;
+  }
+  return true;
+}
+
+} // namespace rb
@@ -0,0 +1,96 @@
+/// \file ExtentMap.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Map of where a file on a FAT volume lies on its block device.
+
+#ifndef RB_EXTENT_MAP_HPP
+#define RB_EXTENT_MAP_HPP
+
+#ifndef __cplusplus
+#error "ExtentMap.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbed {
+class BlockDevice;
+} // namespace mbed
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief The cluster chain of a file, resolved once into runs of consecutive
+/// sectors, so that the file can be read straight from the block device
+/// without going through the filesystem.
+class ExtentMap
+{
+ public:
+  /// \brief Maximum number of runs. More fragmented files are not mapped.
+  static constexpr int kMaxExtents = 16;
+
+  /// \brief Largest sector size, FF_MAX_SS of FatFs.
+  static constexpr std::uint32_t kMaxSectorSize = 4096;
+
+  /// \brief A run of consecutive sectors.
+  struct Extent
+  {
+    std::uint32_t sector; // First sector on the device.
+    std::uint32_t count;  // Number of sectors.
+  };
+
+  /// \brief Start mapping a file, dropping any previous mapping. The file is
+  /// mapped once its runs of sectors have been added in order.
+  ///
+  /// \param device Block device the file lies on. Its read size must divide
+  /// the sector size.
+  /// \param size Size of the file.
+  ///
+  /// \return false if the device cannot be read by sector, or the sectors are
+  /// too big.
+  bool start(
+    mbed::BlockDevice* device,
+    std::uint32_t      sector_size,
+    std::uint32_t      size);
+
+  /// \brief Add the next run of sectors of the file, joined onto the one
+  /// before if they are consecutive.
+  ///
+  /// \return false if there are too many runs, which drops the mapping.
+  bool add(std::uint32_t sector, std::uint32_t count);
+
+  /// \brief Forget the mapping.
+  void clear() { _count = 0; }
+
+  /// \brief Check if a file is mapped.
+  bool mapped() const { return _count > 0; }
+
+  /// \brief Get the number of sectors mapped so far.
+  std::uint32_t sectors() const;
+
+  /// \brief Read from the file straight from the block device. Whole sectors
+  /// are read in place, as many at once as are consecutive, and only partial
+  /// ones go through a bounce buffer.
+  ///
+  /// Not reentrant, since all maps share the bounce buffer.
+  ///
+  /// \param pos Offset in the file.
+  ///
+  /// \return true if successful.
+  bool read(std::uint32_t pos, void* data, std::size_t n) const;
+
+ private:
+  mbed::BlockDevice* _device      = nullptr;
+  std::uint32_t      _sector_size = 0;
+  std::uint32_t      _size        = 0; // Size of the file.
+  int                _count       = 0;
+  Extent             _extents[kMaxExtents];
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_EXTENT_MAP_HPP
@@ -0,0 +1,53 @@
+/// \file Fade.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Gain envelopes for the MusicPlayer.
+
+#include "Fade.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Lowest gain of an exponential ramp, Q16. Ramps to or from silence
+/// jump the rest of the way.
+constexpr std::int32_t kFloor = rb::Fade::kUnity >> 8;
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+void
+Fade::start(std::int32_t gain, long count, Curve curve)
+{
+  gain    = std::min(std::max(gain, 0), kUnity);
+  _target = static_cast<std::uint32_t>(gain) << kExtraBits;
+  _left   = count;
+  _exp    = curve == Exponential;
+  if (count <= 0) {
+    _value = _target;
+    _left  = 0;
+    return;
+  }
+
+  if (!_exp) {
+    _step = static_cast<std::int32_t>(_target - _value) / count;
+    return;
+  }
+
+  // A constant ratio per sample. Only computed once per ramp, so the floating
+  // point costs nothing in the mixer.
+  const std::uint32_t floor = static_cast<std::uint32_t>(kFloor) << kExtraBits;
+  _value                    = std::max(_value, floor);
+  const double ratio = std::pow(
+    static_cast<double>(std::max(_target, floor)) / _value, 1.0 / count);
+  _factor = static_cast<std::uint32_t>(std::min(ratio, 3.0) * (1u << 30));
+}
+
+} // namespace rb
@@ -0,0 +1,98 @@
+/// \file Fade.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Gain envelopes for the MusicPlayer.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// AudioFormat.hpp.
+
+#ifndef RB_FADE_HPP
+#define RB_FADE_HPP
+
+#ifndef __cplusplus
+#error "Fade.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief A gain that ramps between levels one sample at a time, cheaply
+/// enough to be stepped in the inner loop of the mixer.
+class Fade
+{
+ public:
+  /// \brief Full gain, Q16.
+  static constexpr std::int32_t kUnity = 1 << 16;
+
+  // clang-format off
+  /// \brief Shape of a ramp.
+  enum Curve
+  {
+    Linear      = 0 // Straight line in amplitude.
+  , Exponential = 1 // Straight line in decibels, through a -48 dB floor.
+  };
+  // clang-format on
+
+  /// \brief Hold a gain.
+  ///
+  /// \param gain Gain, Q16.
+  void set(std::int32_t gain)
+  {
+    _value = gain << kExtraBits;
+    _left  = 0;
+  }
+
+  /// \brief Ramp from the current gain to another one.
+  ///
+  /// \param gain Gain at the end of the ramp, Q16.
+  /// \param count Length of the ramp in samples.
+  void start(std::int32_t gain, long count, Curve curve);
+
+  /// \brief Check if a ramp is still running.
+  bool active() const { return _left > 0; }
+
+  /// \brief Step the gain by one sample.
+  ///
+  /// \return The gain for the sample, Q16.
+  std::int32_t next();
+
+ private:
+  /// \brief The gain is kept with this many bits below Q16, so that slow
+  /// exponential ramps still move at their start.
+  static constexpr int kExtraBits = 12;
+
+  std::uint32_t _value  = kUnity << kExtraBits; // Gain, Q28.
+  std::uint32_t _target = 0;                    // Gain at the end, Q28.
+  std::int32_t  _step   = 0;                    // Change per sample, Q28.
+  std::uint32_t _factor = 0;                    // Ratio per sample, Q30.
+  bool          _exp    = false;
+  long          _left   = 0; // Samples of the ramp left.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+
+inline std::int32_t
+Fade::next()
+{
+  if (_left > 0) {
+    if (--_left == 0)
+      _value = _target;
+    else if (_exp)
+      _value = static_cast<std::uint64_t>(_value) * _factor >> 30;
+    else
+      _value += _step;
+  }
+  return _value >> kExtraBits;
+}
+
+} // namespace rb
+
+#endif // RB_FADE_HPP
@@ -0,0 +1,65 @@
+/// \file FatVolume.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief FAT filesystem that can map where its files lie on the block device.
+
+#include "FatVolume.hpp"
+
+#include <fcntl.h>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Get the sector size of a volume.
+std::uint32_t
+sectorSize_(const FATFS* fs)
+{
+#if FF_MAX_SS != FF_MIN_SS
+  return fs->ssize;
+#else
+  return FF_MAX_SS;
+#endif
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+bool
+FatVolume::map(const char* path, mbed::BlockDevice* device, ExtentMap& map)
+{
+  map.clear();
+  mbed::fs_file_t handle;
+  if (file_open(&handle, path, O_RDONLY) != 0)
+    return false;
+
+  // The handles of a FATFileSystem are FatFs files. Only this thread uses the
+  // file, and the geometry of the volume is fixed while it is mounted, so both
+  // are read outside of the lock.
+  const FIL*          file    = static_cast<const FIL*>(handle);
+  const FATFS*        fs      = file->obj.fs;
+  const std::uint32_t csize   = fs->csize;
+  const std::uint32_t sector  = sectorSize_(fs);
+  const std::uint32_t size    = f_size(file);
+  const std::uint32_t cluster = csize * sector;
+
+  // Seek one byte into each cluster, which leaves the file on that cluster
+  // rather than at the end of the one before. Seeking forward walks the chain
+  // on from where it was, so the walk is linear in the clusters.
+  bool ok = map.start(device, sector, size);
+  for (std::uint32_t pos = 0; ok && pos < size; pos += cluster) {
+    ok = file_seek(handle, pos + 1, SEEK_SET) == static_cast<off_t>(pos + 1) &&
+         map.add(fs->database + (file->clust - 2) * csize, csize);
+  }
+  file_close(handle);
+
+  if (!ok)
+    map.clear();
+  return map.mapped();
+}
+
+} // namespace rb
@@ -0,0 +1,46 @@
+/// \file FatVolume.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief FAT filesystem that can map where its files lie on the block device.
+
+#ifndef RB_FAT_VOLUME_HPP
+#define RB_FAT_VOLUME_HPP
+
+#ifndef __cplusplus
+#error "FatVolume.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <FATFileSystem.h>
+
+#include "ExtentMap.hpp"
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief FATFileSystem that resolves the cluster chains of its files into
+/// extent maps.
+///
+/// The mapping goes through the file operations of the FATFileSystem, each of
+/// which takes its lock, so it is safe alongside any other use of the volume
+/// from other threads.
+class FatVolume : public FATFileSystem
+{
+ public:
+  using FATFileSystem::FATFileSystem;
+
+  /// \brief Resolve the cluster chain of a file.
+  ///
+  /// \param path Path of the file in the volume, without the mount point.
+  /// \param device Block device the volume is mounted on.
+  ///
+  /// \return true if the file was mapped.
+  bool map(const char* path, mbed::BlockDevice* device, ExtentMap& map);
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_FAT_VOLUME_HPP
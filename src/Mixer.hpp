@@ -0,0 +1,147 @@
+/// \file Mixer.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief The mixing stage of the MusicPlayer: voices resampled to the bank
+/// rate, scaled by their gain and fade, and summed into a bank.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// AudioFormat.hpp.
+
+#ifndef RB_MIXER_HPP
+#define RB_MIXER_HPP
+
+#ifndef __cplusplus
+#error "Mixer.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <algorithm>
+#include <cstdint>
+
+#include "AudioFormat.hpp"
+#include "Fade.hpp"
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Get the gain of a voice, Q8.
+///
+/// \param attenuation Volume reduction of its job, in 1/256ths.
+/// \param duck Further reduction while it is ducked, in 1/256ths.
+int
+mixGain(unsigned int attenuation, unsigned int duck);
+
+/// \brief Resampler of one voice into a mix.
+///
+/// Resampling is linear interpolation in fixed point. A voice at the bank rate
+/// passes through unchanged, one sample late. The fade of the voice is stepped
+/// in the same pass, so it costs no extra walk over the samples.
+class VoiceMixer
+{
+ public:
+  /// \brief Start a voice on its first sample.
+  void prime(int first)
+  {
+    _s0   = first;
+    _s1   = first;
+    _frac = 0;
+  }
+
+  /// \brief Set the rate of the voice's samples and the rate of the mix.
+  void setRates(int in_rate, int out_rate)
+  {
+    _step = (static_cast<std::uint64_t>(in_rate) << 16) / out_rate;
+  }
+
+  /// \brief Add samples of the voice into a mix.
+  ///
+  /// A voice that stops short can be mixed again once next() has samples,
+  /// and goes on right where it stopped.
+  ///
+  /// \param gain Gain of the voice, Q8.
+  /// \param next Callable as bool(int& sample), giving the next input sample,
+  /// signed 16-bit, or false if there is none.
+  ///
+  /// \return The number of samples mixed, short of count if next() ran out.
+  template<typename Next>
+  int mix(Fade& fade, int gain, std::int32_t* acc, int count, Next&& next);
+
+ private:
+  /// \brief Take input samples up to the output position.
+  ///
+  /// \return false if next() ran out first.
+  template<typename Next>
+  bool advance(Next& next);
+
+  int           _s0   = 0; // Signed samples being interpolated between.
+  int           _s1   = 0;
+  std::uint32_t _frac = 0; // Position between _s0 and _s1, Q16.
+  std::uint32_t _step = 0; // Input samples per output sample, Q16.
+};
+
+/// \brief Saturate a mix into DAC samples, rather than wrapping it.
+template<typename Sample>
+void
+mixDown(const std::int32_t* acc, Sample* out, int count);
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+
+inline int
+mixGain(unsigned int attenuation, unsigned int duck)
+{
+  return (256 - std::min(attenuation, 256u)) *
+           static_cast<int>(256 - std::min(duck, 256u)) >>
+         8;
+}
+
+template<typename Next>
+inline bool
+VoiceMixer::advance(Next& next)
+{
+  // The samples are only shifted once the new one is in, so that running out
+  // leaves the voice as it was.
+  for (; _frac >= 1u << 16; _frac -= 1u << 16) {
+    int sample;
+    if (!next(sample))
+      return false;
+    _s0 = _s1;
+    _s1 = sample;
+  }
+  return true;
+}
+
+template<typename Next>
+inline int
+VoiceMixer::mix(Fade& fade, int gain, std::int32_t* acc, int count, Next&& next)
+{
+  if (!advance(next))
+    return 0;
+  for (int i = 0; i < count; ++i) {
+    const int delta  = (_s1 - _s0) * static_cast<int>(_frac >> 1);
+    const int sample = _s0 + (delta >> 15);
+    const int level  = (gain * (fade.next() >> 4)) >> 8; // Q12.
+    acc[i] += (sample * level) >> 12;
+
+    _frac += _step;
+    if (!advance(next))
+      return i + 1;
+  }
+  return count;
+}
+
+template<typename Sample>
+inline void
+mixDown(const std::int32_t* acc, Sample* out, int count)
+{
+  for (int i = 0; i < count; ++i)
+    out[i] = dacSample(std::min<int>(std::max<int>(acc[i], -0x8000), 0x7FFF));
+}
+
+} // namespace rb
+
+#endif // RB_MIXER_HPP
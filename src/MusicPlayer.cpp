@@ -7,16 +7,33 @@
 
 #include "MusicPlayer.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
 #include <cstdint>
 #include <cstring>
-
-#include <mutex>
+#include <utility>
 
 #include <mbed.h>
 #include <rtos.h>
 
 #include <MODDMA.h>
 
+#include "AudioFormat.hpp"
+#include "BankAdapter.hpp"
+#include "BankRing.hpp"
+#include "ClipCache.hpp"
+#include "Dma.hpp"
+#include "ExtentMap.hpp"
+#include "Fade.hpp"
+#include "FatVolume.hpp"
+#include "Mixer.hpp"
+#include "PlayerConfig.hpp"
+#include "SegmentReader.hpp"
+#include "SoundPack.hpp"
+#include "SpscRing.hpp"
+#include "ToneSynth.hpp"
 #include "pinout.hpp"
 
 using namespace AjK; // for MODDMA.
@@ -25,11 +42,24 @@ using namespace AjK; // for MODDMA.
 
 namespace {
 
-/// \brief The number of banks of audio data.
-constexpr int kBankCount = 2;
+using rb::player::kBankCount;
+using rb::player::kBankSize;
+using rb::player::kMinBankSize;
+using rb::player::kMixChunk;
+using rb::player::kStreamReadSize;
+using rb::player::kStreamSize;
+using rb::player::kVoiceChunk;
+using rb::player::kVoiceCount;
+
+/// \brief A DAC sample as moved into DACR by the DMA.
+using Sample_ = rb::player::Sample;
+
+/// \brief The GPDMA transfer width of a sample.
+constexpr std::uint32_t kSampleWidth =
+  sizeof(Sample_) == 2 ? MODDMA::halfword : MODDMA::word;
 
-/// \brief Initialize the DMA controller.
-MODDMA DMA;
+/// \brief The DMA controller, shared with the SD card.
+MODDMA& DMA = rb::dma();
 
 /// \brief Onboard LEDs.
 mbed::BusOut OnboardLEDs(LED4, LED3, LED2, LED1);
@@ -47,75 +77,261 @@ configDACClock_()
   return CCK_SPEED;
 }
 
-// switching audio buffer.
-std::uint32_t audio_buf[kBankCount][MUSIC_PLAYER_AUDIO_BUF_BANK_SIZE]
+// ring of audio buffer banks.
+Sample_ audio_buf[kBankCount][kBankSize]
   __attribute__((section("AHBSRAM0")));
 
+// linked list items chaining the banks into a circular scatter-gather ring.
+// lli[i] describes bank i, and is loaded by the GPDMA when bank i - 1 finishes.
+MODDMA_LLI bank_lli[kBankCount] __attribute__((section("AHBSRAM0")));
+
+// DACCNTVAL of each bank, so the sample rate can change from one bank to the
+// next.
+volatile std::uint16_t bank_cntval[kBankCount];
+
+/// \brief Statistics of the audio path. Written from the bank interrupt and
+/// both threads without locking.
+MusicPlayerStats audio_stats;
+
+/// \brief Cycle count when the last bank finished.
+volatile std::uint32_t bank_done_cycles;
+
+/// \brief Start the cycle counter used to time the interrupt and refills.
+void
+startCycleCounter_()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/// \brief Add a value to a histogram.
+void
+record_(MusicPlayerHistogram& hist, std::uint32_t value)
+{
+  const int bucket = value < 2 ? 0 : 31 - __builtin_clz(value);
+  ++hist.buckets[std::min<int>(bucket, MusicPlayerHistogram_Buckets - 1)];
+  ++hist.count;
+  hist.max = std::max<std::uint32_t>(hist.max, value);
+}
+
+/// \brief Print a histogram on one line.
+void
+printHistogram_(const char* name, const MusicPlayerHistogram& hist)
+{
+  printf("[MusicPlayer] %-10s n %u, max %u |", name, hist.count, hist.max);
+  for (unsigned int bucket : hist.buckets)
+    printf(" %u", bucket);
+  printf("\r\n");
+}
+
+/// \brief Whether to print the statistics of the audio path when the player
+/// goes idle. Always on in the debug profile.
+#ifdef MBED_DEBUG
+constexpr bool kPrintStats = true;
+#else
+constexpr bool kPrintStats = MUSIC_PLAYER_PRINT_STATS;
+#endif
+
+/// \brief Print the statistics of the audio path.
+void
+printStats_()
+{
+  printf(
+    "[MusicPlayer] banks %u of %u samples, late refills %u, underruns %u\r\n",
+    audio_stats.banks,
+    audio_stats.bank_samples,
+    audio_stats.late_refills,
+    audio_stats.underruns);
+  printf("[MusicPlayer] voice underruns");
+  for (unsigned int count : audio_stats.voice_underruns)
+    printf(" %u", count);
+  printf("\r\n");
+  printHistogram_("refill us", audio_stats.refill_us);
+  printHistogram_("read bytes", audio_stats.read_bytes);
+  printHistogram_("isr cycles", audio_stats.isr_cycles);
+}
+
 /// \brief The callback functor type for when the DMA encounters an error.
 struct ErrorCallback_
 {
   void operator()() { error("Error in DMA Callback"); }
 };
 
-/// \brief The callback functor type for when the music player DAC runs out of
-/// samples.
+/// \brief The callback functor type for when the DAC finishes a bank.
+///
+/// The DMA has already moved on to the next bank through its LLI by the time
+/// this is called, so all that is left to do is to advance the read index,
+/// switch the DAC to the rate of the new bank and wake up the refill thread.
 struct DataCallback_
 {
-  osThreadId     tid;
-  volatile int&  curr_bank;
-  MODDMA_Config* bank_conf;
-
-  DataCallback_(
-    osThreadId     tid_,
-    volatile int&  curr_bank_,
-    MODDMA_Config* bank_conf_) :
-      tid(tid_),
-      curr_bank(curr_bank_),
-      bank_conf(bank_conf_)
+  osThreadId    tid;
+  rb::BankRing& ring;
+
+  DataCallback_(osThreadId tid_, rb::BankRing& ring_) : tid(tid_), ring(ring_)
   {
   }
 
   void operator()()
   {
-    curr_bank = (curr_bank + 1) % kBankCount;
-    DMA.Disable((MODDMA::CHANNELS)DMA.getConfig()->channelNum());
-    DMA.Prepare(&bank_conf[curr_bank]);
+    const std::uint32_t start = DWT->CYCCNT;
+
+    ring.consume();
+    LPC_DAC->DACCNTVAL = bank_cntval[ring.slot(ring.consumed())];
     if (DMA.irqType() == MODDMA::TcIrq)
       DMA.clearTcIrq();
 
+    bank_done_cycles = start;
     osSignalSet(tid, EVENT_FLAG_AUDIO_LOAD);
+
+    ++audio_stats.banks;
+    record_(audio_stats.isr_cycles, DWT->CYCCNT - start);
   }
 };
 
-// clang-format off
-/// \brief Supported file types.
-enum FileType_
+/// \brief The GPDMA control word for a single bank transfer to the DAC.
+///
+/// \param samples The number of samples in the bank.
+std::uint32_t
+bankControl_(int samples)
 {
-  FileType_Undefined = 0
-, FileType_u8pcm    = 1
-};
-// clang-format on
+  return DMA.CxControl_TransferSize(samples) |
+         DMA.CxControl_SBSize(MODDMA::_1) | DMA.CxControl_DBSize(MODDMA::_1) |
+         DMA.CxControl_SWidth(kSampleWidth) |
+         DMA.CxControl_DWidth(kSampleWidth) | DMA.CxControl_SI() |
+         DMA.CxControl_I();
+}
+
+/// \brief Link the bank ring together into a closed loop of full banks.
+void
+linkBanks_()
+{
+  const std::uint32_t control = bankControl_(kBankSize);
+  for (int i = 0; i < kBankCount; ++i) {
+    bank_lli[i]
+      .srcAddr(reinterpret_cast<std::uint32_t>(&audio_buf[i]))
+      ->dstAddr(reinterpret_cast<std::uint32_t>(&LPC_DAC->DACR))
+      ->nextLLI(
+        reinterpret_cast<std::uint32_t>(&bank_lli[(i + 1) % kBankCount]))
+      ->control(control);
+  }
+}
 
 struct U8PCMFileInfo_
 {
   FILE* file;
+  bool  shared; // file is the sound pack, which stays open.
 
-  void destroy() { std::fclose(file); }
+  void destroy()
+  {
+    if (!shared)
+      std::fclose(file);
+  }
+};
+
+/// \brief RIFF/WAVE file holding 8-bit unsigned or 16-bit signed PCM, or mono
+/// IMA ADPCM.
+struct WavFileInfo_
+{
+  FILE* file;
+  bool  shared; // file is the sound pack, which stays open.
+
+  void destroy()
+  {
+    if (!shared)
+      std::fclose(file);
+  }
 };
 
 /// \brief Structure about a file. Very heavy.
 struct FileInfo_
 {
-  const char* name;
-  FileType_   type;
-  int         rate;
+  const char*       name;
+  rb::Segment::Type type;
+  int               rate;     // Samples per second, or 0 for the default rate.
+  int               bits;     // Bits per sample.
+  int               channels; // Mixed down to mono on playback.
+  int               block;    // Bytes per frame, or per block of frames.
+  long              size;     // Bytes of sample data.
+  long              pos;      // Offset of the next read in the file.
+  mbed::FileHandle* handle;   // Handle under the file, for sample data.
+  const rb::ExtentMap* map;   // Where the file lies on the card, or null.
   union {
     U8PCMFileInfo_ u8pcm;
+    WavFileInfo_   wav;
   };
 };
 
-/// \brief Queries the file, and fills out file info structure.
-FileType_
+/// \brief The sound pack, if there is one. Owned by the reader thread.
+rb::SoundPack sound_pack;
+
+/// \brief Block device under the filesystem, to read mapped files from. Null
+/// if none was given.
+mbed::BlockDevice* block_device = nullptr;
+
+/// \brief Filesystem to map files in. Null if none was given.
+rb::FatVolume* fat_volume = nullptr;
+
+/// \brief Where the sound pack lies on the card, if mapped.
+rb::ExtentMap pack_map;
+
+/// \brief Map where a file lies on the card, so that it can be read without the
+/// filesystem.
+///
+/// \return true if the file was mapped.
+bool
+mapFile_(const char* fname, rb::ExtentMap& map)
+{
+  static constexpr char kMount[] = "/" AUX_MOUNT_POINT "/";
+  if (!fat_volume || std::strncmp(fname, kMount, sizeof(kMount) - 1) != 0)
+    return false;
+  return fat_volume->map(fname + sizeof(kMount) - 1, block_device, map);
+}
+
+/// \brief Get the map of a file opened by openFile_().
+const rb::ExtentMap*
+mapOf_(bool shared)
+{
+  return shared && pack_map.mapped() ? &pack_map : nullptr;
+}
+
+/// \brief Open a file, from the sound pack if it is in there.
+///
+/// \param shared Set if the returned file is the sound pack, which stays open.
+/// \param size Set to the size of the file.
+///
+/// \return The file positioned at its start, or null on failure.
+FILE*
+openFile_(const char* fname, bool& shared, long& size)
+{
+  if (const rb::SoundPack::Entry* entry = sound_pack.find(fname)) {
+    shared = true;
+    size   = entry->size;
+    if (std::fseek(sound_pack.file(), entry->offset, SEEK_SET))
+      return nullptr;
+    return sound_pack.file();
+  }
+
+  shared     = false;
+  FILE* file = std::fopen(fname, "rb");
+  if (!file)
+    return nullptr;
+  std::fseek(file, 0, SEEK_END);
+  size = std::ftell(file);
+  std::fseek(file, 0, SEEK_SET);
+  return file;
+}
+
+/// \brief Get the handle under an open file, so that sample data can be read
+/// without going through the stdio buffer.
+mbed::FileHandle*
+handleOf_(FILE* file)
+{
+  return mbed::mbed_file_handle(fileno(file));
+}
+
+/// \brief Queries the file, and fills out file info structure. On success the
+/// file is positioned at its sample data.
+rb::Segment::Type
 initFile_(const char* fname, FileInfo_& info)
 {
   // Get name.
@@ -123,20 +339,56 @@ initFile_(const char* fname, FileInfo_& info)
 
   { // Get type.
     const char* dot = std::strrchr(fname, '.');
-    if (!dot || dot == fname)
-      info.type = FileType_u8pcm;
+    if (
+      dot && dot != fname && std::strlen(dot) == 4 &&
+      std::tolower(dot[1]) == 'w' && std::tolower(dot[2]) == 'a' &&
+      std::tolower(dot[3]) == 'v')
+      info.type = rb::Segment::Wav;
     else
-      info.type = FileType_u8pcm;
+      info.type = rb::Segment::U8Pcm;
   }
 
   // Get rate and init decoding structs.
   switch (info.type) {
 
-    case FileType_u8pcm: {
-      info.u8pcm.file = std::fopen(info.name, "rb");
+    case rb::Segment::U8Pcm: {
+      info.rate       = 0;
+      info.bits       = 8;
+      info.channels   = 1;
+      info.block      = 1;
+      info.u8pcm.file = openFile_(info.name, info.u8pcm.shared, info.size);
       if (!info.u8pcm.file)
         goto err;
-      info.rate = 0;
+      info.pos    = std::ftell(info.u8pcm.file);
+      info.handle = handleOf_(info.u8pcm.file);
+      info.map    = mapOf_(info.u8pcm.shared);
+    } break;
+
+    case rb::Segment::Wav: {
+      long          size;
+      rb::WavFormat format = {};
+      info.wav.file = openFile_(info.name, info.wav.shared, size);
+      if (!info.wav.file)
+        goto err;
+      if (!rb::parseWav(info.wav.file, size, format)) {
+        debug(
+          "\r\n[MusicPlayer] Unsupported WAV format %d: %d bits, %d channels",
+          format.tag,
+          format.bits,
+          format.channels);
+        info.wav.destroy();
+        goto err;
+      }
+      if (format.tag == rb::kWavImaAdpcm)
+        info.type = rb::Segment::Adpcm;
+      info.rate     = format.rate;
+      info.bits     = format.bits;
+      info.channels = format.channels;
+      info.block    = format.block;
+      info.size     = format.size;
+      info.pos      = std::ftell(info.wav.file);
+      info.handle   = handleOf_(info.wav.file);
+      info.map      = mapOf_(info.wav.shared);
     } break;
 
     default:
@@ -146,7 +398,7 @@ initFile_(const char* fname, FileInfo_& info)
   return info.type;
 
 err:
-  info.type = FileType_Undefined;
+  info.type = rb::Segment::Undefined;
   return info.type;
 }
 
@@ -154,139 +406,1117 @@ void
 deinitFile_(FileInfo_& info)
 {
   switch (info.type) {
-    case FileType_u8pcm:
+    case rb::Segment::U8Pcm:
       info.u8pcm.destroy();
       break;
 
+    case rb::Segment::Wav:
+    case rb::Segment::Adpcm:
+      info.wav.destroy();
+      break;
+
     default:
       break;
   }
+  info.type = rb::Segment::Undefined;
+}
+
+/// \brief Describe the sample data of an open file.
+rb::Segment
+segmentOf_(const FileInfo_& info, int clip)
+{
+  return {
+    info.type,
+    info.rate,
+    info.bits,
+    info.channels,
+    info.block,
+    info.size,
+    clip};
 }
 
-/// \brief Helper to read into audio buffer from file.
+/// \brief Number of segment descriptors that can be in flight per voice.
+constexpr std::size_t kSegmentCount = 4;
+
+// raw sample data read ahead from the card by the reader thread, per voice.
+// Shares AHBSRAM0 with the bank ring, so that the clip cache has all of
+// AHBSRAM1.
+std::uint8_t stream_buf[kVoiceCount][kStreamSize]
+  __attribute__((section("AHBSRAM0")));
+
+static_assert(
+  sizeof(audio_buf) + sizeof(bank_lli) + sizeof(stream_buf) <= 16 * 1024,
+  "Bank ring and stream rings do not fit in AHBSRAM0");
+
+// descriptors of the segments in the stream rings, per voice.
+rb::Segment segment_buf[kVoiceCount][kSegmentCount];
+
+/// \brief Size of the clip cache in bytes.
+constexpr std::size_t kClipCacheSize = MUSIC_PLAYER_CLIP_CACHE_SIZE;
+
+/// \brief Largest clip that goes into the clip cache. Anything bigger, such as
+/// music, is streamed so it does not flush the frequently spoken clips.
+constexpr long kClipCacheMaxClip = MUSIC_PLAYER_CLIP_CACHE_MAX_CLIP;
+static_assert(
+  kClipCacheMaxClip <= static_cast<long>(kClipCacheSize),
+  "Largest cached clip does not fit in the clip cache");
+
+// frequently played clips, kept in memory to skip the card altogether.
+std::uint8_t clip_cache_buf[kClipCacheSize]
+  __attribute__((section("AHBSRAM1")));
+static_assert(
+  sizeof(clip_cache_buf) <= 16 * 1024,
+  "Clip cache does not fit in AHBSRAM1");
+
+rb::ClipCache clip_cache(clip_cache_buf, kClipCacheSize);
+
+// clang-format off
+/// \brief Playback state of a voice.
+enum VoiceState_
+{
+  VoiceState_Idle      = 0
+, VoiceState_Starting  = 1 // Waiting for its first samples.
+, VoiceState_Playing   = 2
+, VoiceState_Finishing = 3 // Fully mixed, waiting for its last bank to play.
+, VoiceState_Flushing  = 4 // Cancelled, dropping what the reader sent ahead.
+};
+// clang-format on
+
+// clang-format off
+/// \brief Outcome of taking samples from a voice.
+enum Fetch_
+{
+  Fetch_Ok      = 0
+, Fetch_Starved = 1 // The reader thread is behind, nothing to decode yet.
+, Fetch_Ended   = 2
+};
+// clang-format on
+
+/// \brief A voice: the clips of one job, streamed back to back and mixed with
+/// the other voices.
 ///
-/// \return 0 on success, 1 on failure.
+/// Each voice has its own rings, so a long music file streaming on one voice
+/// never holds up a clip on another.
+struct Voice_
+{
+  Voice_(std::uint8_t* stream_storage, rb::Segment* segment_storage) :
+      stream(stream_storage, kStreamSize),
+      segments(segment_storage, kSegmentCount),
+      job(nullptr),
+      requested(false),
+      cancel(false),
+      reading(false),
+      unread(0),
+      state(VoiceState_Idle),
+      seq(&stream, &clip_cache)
+  {
+  }
+
+  // ------------------------------ Shared -------------------------------
+
+  rb::SpscRing<std::uint8_t> stream;    // Sample data read ahead.
+  rb::SpscRing<rb::Segment>  segments;  // Segments, ended by an undefined one.
+  MusicPlayerJob*            job;       // Job being played.
+  std::atomic<bool>          requested; // Hands the job to the reader thread.
+  std::atomic<bool>          cancel;    // Tells the reader to drop the job.
+
+  // ------------------------ Reader thread only -------------------------
+
+  bool      reading; // The files of the job are being read.
+  int       next;    // Next file of the job to open.
+  FileInfo_     file;   // File being streamed, if unread is not 0.
+  long          unread; // Bytes of the file left to stream.
+  rb::ExtentMap map;    // Where the file being streamed lies on the card.
+
+  // ------------------------- Audio thread only -------------------------
+
+  VoiceState_       state;
+  unsigned int      order;    // Start order. The oldest voice sets the rate.
+  unsigned int      end_bank; // Bank after the last one holding the voice.
+  rb::SegmentReader seq;      // Clips of the job, decoded back to back.
+  Sample_           in[kVoiceChunk]; // Decoded samples waiting to be mixed.
+  int               in_pos;
+  int               in_count;
+  int               in_rate; // Rate of the decoded samples, times the speed.
+  rb::ToneSynth     synth;   // Synthesizer of a tone job.
+  int               tone;    // Next tone of a tone job.
+  rb::Fade          fade;    // Gain envelope, stepped per mixed sample.
+  bool              fading_out;
+  bool              starved; // Ran out of data in the bank being mixed.
+  rb::VoiceMixer    mixer;
+};
+
+/// \brief Construct the voices on their slices of the ring storage.
+template<std::size_t... I>
+std::array<Voice_, sizeof...(I)>
+makeVoices_(std::index_sequence<I...>)
+{
+  return {{Voice_(stream_buf[I], segment_buf[I])...}};
+}
+
+std::array<Voice_, kVoiceCount> voices =
+  makeVoices_(std::make_index_sequence<kVoiceCount>());
+
+/// \brief Jobs waiting for a voice, highest priority class first.
+rtos::Queue<MusicPlayerJob, MUSIC_PLAYER_JOB_QUEUE_DEPTH> jobs;
+
+/// \brief Number of priority classes.
+constexpr int kPriorityCount = MusicPlayerPriority_Alarm + 1;
+
+/// \brief Number of jobs in the queue by priority class, so that a voice can
+/// be preempted for one without taking it out of the queue first.
+std::atomic<int> queued[kPriorityCount];
+
+/// \brief Get the priority class of a job, clamped to the known ones.
 int
-readBuffer_(FileInfo_& file_info, bool& more, std::uint32_t* buffer)
-{
-  switch (file_info.type) {
-    case FileType_u8pcm: {
-      FILE* const fp = file_info.u8pcm.file;
-      std::size_t read_ct =
-        std::fread(buffer, 1, MUSIC_PLAYER_AUDIO_BUF_BANK_SIZE, fp);
-      if (read_ct < MUSIC_PLAYER_AUDIO_BUF_BANK_SIZE) {
-        if (std::ferror(fp)) {
-          return 1;
-        } else if (std::feof(fp)) {
-          std::memset(
-            buffer + read_ct,
-            0,
-            (MUSIC_PLAYER_AUDIO_BUF_BANK_SIZE - read_ct) * sizeof(*buffer));
-          more = false;
-        }
+classOf_(const MusicPlayerJob* job)
+{
+  return std::min(std::max(job->priority, 0), kPriorityCount - 1);
+}
+
+/// \brief The audio thread. Owns the DMA, the bank ring and the consumer side
+/// of the voices, and mixes the voices into the banks. Runs above the reader
+/// thread so that a refill is never held up by a slow card access.
+rtos::Thread audio_thread(
+  osPriorityHigh,
+  MUSIC_PLAYER_THREAD_STACK_SIZE,
+  nullptr,
+  "MusicPlayer");
+
+/// \brief The reader thread. Owns the open files and the clip cache, and keeps
+/// the stream rings of the voices topped up with large reads.
+rtos::Thread reader_thread(
+  osPriorityAboveNormal,
+  MUSIC_PLAYER_READER_STACK_SIZE,
+  nullptr,
+  "MusicReader");
+
+/// \brief Reader thread flag set whenever a voice is handed a new job.
+constexpr std::uint32_t kReaderStartFlag = 0x1;
+
+/// \brief Reader thread flag set whenever space is freed in the rings.
+constexpr std::uint32_t kReaderSpaceFlag = 0x2;
+
+/// \brief Push a segment descriptor of a voice, and wake the audio thread.
+/// There must be space for it.
+void
+pushSegment_(Voice_& v, const rb::Segment& seg)
+{
+  v.segments.write(&seg, 1);
+  osSignalSet(audio_thread.get_id(), EVENT_FLAG_AUDIO_LOAD);
+}
+
+/// \brief Size of a card sector.
+constexpr std::size_t kSectorSize = 512;
+
+/// \brief Read sample data from an open file.
+///
+/// A file mapped on the card is read straight from the block device, without
+/// touching the filesystem. Other reads go to the handle under the file,
+/// skipping the stdio buffer.
+/// Those of whole sectors at sector offsets also skip the FATFS sector buffer,
+/// and land in place right from the card. Since stdio may have read ahead while
+/// the header was parsed, and files in the sound pack share one handle, each
+/// read is positioned explicitly.
+void
+readFile_(FileInfo_& info, std::uint8_t* data, std::size_t n)
+{
+  if (info.map) {
+    if (!info.map->read(info.pos, data, n))
+      error("[MusicPlayer] Error reading file %s!", info.name);
+    info.pos += n;
+    record_(audio_stats.read_bytes, n);
+    return;
+  }
+
+  mbed::FileHandle* handle = info.handle;
+  if (
+    !handle || handle->seek(info.pos, SEEK_SET) != info.pos ||
+    handle->read(data, n) != static_cast<ssize_t>(n))
+    error("[MusicPlayer] Error reading file %s!", info.name);
+  info.pos += n;
+  record_(audio_stats.read_bytes, n);
+}
+
+/// \brief Load the sample data of an open file into a clip cache entry.
+void
+loadClip_(FileInfo_& info, int clip)
+{
+  std::size_t   offset = 0;
+  std::uint8_t* span;
+  while (std::size_t n = clip_cache.writeSpan(clip, offset, span)) {
+    readFile_(info, span, n);
+    offset += n;
+  }
+  clip_cache.publish(clip);
+}
+
+/// \brief Stream the next chunk of a voice's open file into its stream ring.
+///
+/// \return false if there is no room for a chunk yet.
+bool
+streamChunk_(Voice_& v)
+{
+  // Only read in large chunks, unless the file is almost done.
+  if (v.stream.space() < std::min<std::size_t>(kStreamReadSize, v.unread))
+    return false;
+
+  std::uint8_t* span;
+  std::size_t   n = v.stream.writeSpan(span);
+  n = std::min({n, kStreamReadSize, static_cast<std::size_t>(v.unread)});
+  // End on a sector boundary, so that the reads after an unaligned start of
+  // the sample data are all whole sectors.
+  if (n > kSectorSize)
+    n -= (v.file.pos + n) % kSectorSize;
+  readFile_(v.file, span, n);
+  v.stream.commit(n);
+
+  v.unread -= n;
+  if (v.unread == 0)
+    deinitFile_(v.file);
+  osSignalSet(audio_thread.get_id(), EVENT_FLAG_AUDIO_LOAD);
+  return true;
+}
+
+/// \brief Advance the reading of a voice by one step: a chunk of the file being
+/// streamed, or the next file of its job.
+///
+/// \param clip_info Segments for the clips in the clip cache, by clip id.
+///
+/// \return true if any progress was made.
+bool
+readVoice_(Voice_& v, rb::Segment* clip_info)
+{
+  if (!v.reading) {
+    if (!v.requested.exchange(false, std::memory_order_acquire))
+      return false;
+    v.reading = true;
+    v.next    = 0;
+  }
+  if (v.cancel.exchange(false, std::memory_order_acquire)) {
+    // Skip to the end of the job, so that only its end marker is sent.
+    if (v.unread > 0)
+      deinitFile_(v.file);
+    v.unread = 0;
+    v.next   = v.job->count;
+  }
+  if (v.unread > 0)
+    return streamChunk_(v);
+  if (!v.segments.space())
+    return false;
+
+  if (v.next == v.job->count) {
+    v.reading = false;
+    pushSegment_(v, {rb::Segment::Undefined, 0, 0, 0, 0, 0, -1});
+    return true;
+  }
+  const char* name = v.job->file_names[v.next++];
+
+  // Serve straight from memory on a cache hit.
+  const int hit = clip_cache.acquire(name);
+  if (hit >= 0) {
+    pushSegment_(v, clip_info[hit]);
+    return true;
+  }
+
+  if (!initFile_(name, v.file))
+    error("[MusicPlayer] Cannot open file %s!", v.file.name);
+
+  int clip = -1;
+  if (v.file.size <= kClipCacheMaxClip)
+    clip = clip_cache.insert(name, v.file.size);
+  if (clip >= 0) {
+    loadClip_(v.file, clip);
+    clip_info[clip] = segmentOf_(v.file, clip);
+    pushSegment_(v, clip_info[clip]);
+    deinitFile_(v.file);
+  } else {
+    // Resolve the cluster chain once, and stream without the filesystem.
+    if (!v.file.map && mapFile_(name, v.map))
+      v.file.map = &v.map;
+    pushSegment_(v, segmentOf_(v.file, -1));
+    v.unread = v.file.size;
+    if (!v.unread)
+      deinitFile_(v.file);
+  }
+  return true;
+}
+
+void
+readerThread_()
+{
+  // segments for the clips in the clip cache, by clip id.
+  static rb::Segment clip_info[rb::ClipCache::kMaxClips];
+
+  // Without a pack, every clip is opened from its own file.
+  if (sound_pack.open(MUSIC_PLAYER_SOUND_PACK)) {
+    printf("[MusicPlayer] Using sound pack %s\r\n", MUSIC_PLAYER_SOUND_PACK);
+    if (mapFile_(MUSIC_PLAYER_SOUND_PACK, pack_map))
+      printf("[MusicPlayer] Reading sound pack straight from the card\r\n");
+  }
+
+  // Serve the voices round robin, a chunk at a time, so that all of them are
+  // kept topped up.
+  while (true) {
+    bool progress = false;
+    for (Voice_& v : voices)
+      progress |= readVoice_(v, clip_info);
+    if (!progress)
+      ThisThread::flags_wait_any(kReaderStartFlag | kReaderSpaceFlag);
+  }
+}
+
+/// \brief DAC clock frequency.
+int dac_clock;
+
+/// \brief Sample rate of the bank being mixed.
+int mix_rate = MUSIC_PLAYER_DEFAULT_PCM_RATE;
+
+/// \brief Start order of the next voice.
+unsigned int voice_order = 0;
+
+/// \brief Length of the banks being mixed. Kept from one session to the next,
+/// so that a fast card gets small banks and a short time to first sound.
+rb::BankAdapter bank_adapter(kBankCount, kMinBankSize, kBankSize);
+
+/// \brief Compute a voice's resampling step from the rate of its samples to
+/// the bank rate.
+void
+updateStep_(Voice_& v)
+{
+  v.mixer.setRates(v.in_rate, mix_rate);
+}
+
+/// \brief Sample rate tones are synthesized at.
+constexpr int kToneRate = MUSIC_PLAYER_DEFAULT_PCM_RATE;
+
+/// \brief Synthesize the next samples of a tone job into a voice's input
+/// buffer, moving on to its next tone as needed.
+///
+/// \return false once the voice has no more samples.
+bool
+fetchTones_(Voice_& v)
+{
+  int read_ct;
+  while (!(read_ct = v.synth.render(v.in, kVoiceChunk))) {
+    if (v.tone == v.job->count)
+      return false;
+    const MusicPlayerTone& tone = v.job->tones[v.tone++];
+    v.synth.start(
+      {tone.start_hz,
+       tone.end_hz,
+       tone.duration_ms,
+       tone.attack_ms,
+       tone.release_ms,
+       tone.level},
+      kToneRate);
+  }
+
+  v.in_pos   = 0;
+  v.in_count = read_ct;
+  v.in_rate  = static_cast<int>(kToneRate * v.job->speed);
+  updateStep_(v);
+  return true;
+}
+
+/// \brief Decode the next samples of a voice into its input buffer, moving on
+/// to its next segment as needed. Never waits for the reader thread, which is
+/// left to mixVoice_().
+Fetch_
+fetchVoice_(Voice_& v)
+{
+  if (v.job->tones)
+    return fetchTones_(v) ? Fetch_Ok : Fetch_Ended;
+
+  rb::SegmentReader& seq = v.seq;
+  while (true) {
+    if (seq.done()) {
+      if (seq.segment().clip >= 0) {
+        clip_cache.release(seq.segment().clip);
+        seq.reset();
       }
-      for (int i = read_ct - 1; i >= 0; --i)
-        buffer[i] = reinterpret_cast<std::uint8_t*>(buffer)[i] << 8;
-    } break;
+      rb::Segment next;
+      if (!v.segments.read(&next, 1))
+        return Fetch_Starved;
+      reader_thread.flags_set(kReaderSpaceFlag);
 
-    default:
-      return 1;
+      if (next.type == rb::Segment::Undefined)
+        return Fetch_Ended;
+      if (!next.rate)
+        next.rate = MUSIC_PLAYER_DEFAULT_PCM_RATE;
+      seq.start(next);
+      continue;
+    }
+
+    const int read_ct = seq.read(v.in, kVoiceChunk);
+    if (read_ct < 0) {
+      error("[MusicPlayer] Error decoding stream!");
+      return Fetch_Ended;
+    }
+    if (read_ct == 0)
+      return Fetch_Starved;
+    reader_thread.flags_set(kReaderSpaceFlag);
+
+    v.in_pos   = 0;
+    v.in_count = read_ct;
+    v.in_rate  = static_cast<int>(seq.segment().rate * v.job->speed);
+    updateStep_(v);
+    return Fetch_Ok;
   }
-  return 0;
 }
 
-} // namespace
+/// \brief Take the next decoded sample of a voice.
+///
+/// \param sample Set to the sample, signed.
+Fetch_
+nextSample_(Voice_& v, int& sample)
+{
+  if (v.in_pos == v.in_count) {
+    const Fetch_ fetch = fetchVoice_(v);
+    if (fetch != Fetch_Ok)
+      return fetch;
+  }
+  sample = static_cast<int>(v.in[v.in_pos++]) - 0x8000;
+  return Fetch_Ok;
+}
 
-// ====================== Global Definitions =========================
+/// \brief Get the first samples of a starting voice, unless they are not in
+/// yet and waiting is not allowed.
+///
+/// \param produced Index of the bank being mixed.
+void
+primeVoice_(Voice_& v, bool wait, unsigned int produced)
+{
+  int    first;
+  Fetch_ fetch;
+  while ((fetch = nextSample_(v, first)) == Fetch_Starved) {
+    if (!wait)
+      return;
+    osSignalWait(EVENT_FLAG_AUDIO_LOAD, osWaitForever);
+  }
+  if (fetch == Fetch_Ended) {
+    v.state    = VoiceState_Finishing;
+    v.end_bank = produced;
+    return;
+  }
+  v.mixer.prime(first);
+  v.state = VoiceState_Playing;
+}
 
-extern "C" void
-playMusic(const char* file_name, double initial_speed)
+/// \brief Prime the starting voices.
+///
+/// \param produced Index of the bank about to be mixed.
+/// \param running Whether the DMA is playing the banks already.
+///
+/// \return true if a voice joined that outranks all the others playing, so the
+/// banks queued ahead should be mixed again with it.
+bool
+primeVoices_(unsigned int produced, bool running)
 {
-  // Non-reentrant function due to need of static variables and contention on
-  // DMA bus.
-  static rtos::Mutex mutex;
-  std::scoped_lock   lock(mutex);
+  int top = -1;
+  for (const Voice_& v : voices)
+    if (v.state == VoiceState_Playing)
+      top = std::max(top, classOf_(v.job));
 
-  static const int kClockFreq = configDACClock_();
+  // Voices only hold up the mix for their first samples before the banks
+  // start to play, with nothing else to play meanwhile. Once they do, a voice
+  // joins with the first bank mixed after its samples are in.
+  const bool wait      = !running && top < 0;
+  bool       outranked = false;
+  for (Voice_& v : voices) {
+    if (v.state != VoiceState_Starting)
+      continue;
+    primeVoice_(v, wait, produced);
+    if (!wait && v.state == VoiceState_Playing && classOf_(v.job) > top)
+      outranked = true;
+  }
+  return outranked;
+}
+
+/// \brief Mark a job as done, or cancelled if it was, and signal it.
+void
+retireJob_(MusicPlayerJob* job)
+{
+  job->state = job->cancel ? MusicPlayerJob_Cancelled : MusicPlayerJob_Done;
+  if (job->done)
+    job->done(job);
+}
 
-  // allocate large decoding structs in static memory.
-  static FileInfo_ file_info;
+/// \brief Take the next queued job, skipping the ones cancelled while queued.
+///
+/// \return false if no job came in before the timeout.
+bool
+takeJob_(MusicPlayerJob*& job, rtos::Kernel::Clock::duration_u32 timeout)
+{
+  while (jobs.try_get_for(timeout, &job)) {
+    --queued[classOf_(job)];
+    if (!job->cancel)
+      return true;
+    retireJob_(job);
+  }
+  return false;
+}
 
-  bool more = true;
+/// \brief Value of MusicPlayerJob::cancel for a job cut to make room for
+/// another, which skips its fade out.
+constexpr int kCancelNow = 2;
 
-  volatile int   curr_bank = 0;
-  MODDMA_Config  bank_conf[kBankCount];
-  DataCallback_  callback_d(osThreadGetId(), curr_bank, bank_conf);
-  ErrorCallback_ callback_e;
+/// \brief Get the length of a fade in mixed samples.
+long
+fadeLength_(unsigned int ms)
+{
+  return static_cast<long>(ms) * mix_rate / 1000;
+}
+
+/// \brief Get the shape of a job's fades.
+rb::Fade::Curve
+curveOf_(const MusicPlayerJob* job)
+{
+  return job->fade_curve == MusicPlayerFade_Exponential
+           ? rb::Fade::Exponential
+           : rb::Fade::Linear;
+}
+
+/// \brief Hand a job to a voice. Its files are opened by the reader thread,
+/// and it joins the mix once the first of them is in. Tones join at once.
+void
+startVoice_(Voice_& v, MusicPlayerJob* job)
+{
+  job->state = MusicPlayerJob_Playing;
+
+  v.job          = job;
+  v.state        = VoiceState_Starting;
+  v.order        = voice_order++;
+  v.in_pos       = 0;
+  v.in_count     = 0;
+  v.synth        = rb::ToneSynth();
+  v.tone         = 0;
+  v.fading_out   = false;
+  v.seq.reset();
+  v.fade.set(job->fade_in_ms ? 0 : rb::Fade::kUnity);
+  v.fade.start(rb::Fade::kUnity, fadeLength_(job->fade_in_ms), curveOf_(job));
+  if (job->tones)
+    return;
+
+  v.cancel.store(false, std::memory_order_relaxed);
+  v.requested.store(true, std::memory_order_release);
+  reader_thread.flags_set(kReaderStartFlag);
+}
+
+/// \brief Start queued jobs on free voices. If there are none, and a job of a
+/// higher class than some voice is queued, cancel the voice of the lowest class
+/// to make room for it.
+void
+pollJobs_()
+{
+  for (Voice_& v : voices) {
+    if (v.state != VoiceState_Idle)
+      continue;
+    MusicPlayerJob* job;
+    if (!takeJob_(job, 0ms))
+      return;
+    startVoice_(v, job);
+  }
 
-  // Open file and get its data.
-  if (!initFile_(file_name, file_info)) {
-    error("[MusicPlayer] Cannot open file %s!", file_info.name);
+  // A voice being flushed is about to come free, so preempt one at a time.
+  Voice_* lowest = nullptr;
+  for (Voice_& v : voices) {
+    if (v.state == VoiceState_Flushing)
+      return;
+    if (
+      (v.state == VoiceState_Starting || v.state == VoiceState_Playing) &&
+      (!lowest || classOf_(v.job) < classOf_(lowest->job)))
+      lowest = &v;
+  }
+  if (!lowest)
     return;
+  for (int c = classOf_(lowest->job) + 1; c < kPriorityCount; ++c) {
+    if (queued[c].load(std::memory_order_relaxed) > 0) {
+      lowest->job->cancel = kCancelNow;
+      return;
+    }
   }
+}
 
-  // Fill initial two buffer banks.
-  for (int i = 0; i < kBankCount; ++i) {
-    if (readBuffer_(file_info, more, audio_buf[i])) {
-      error("[MusicPlayer] Error reading file %s!", file_info.name);
-      goto end;
+/// \brief Stop mixing a voice. A voice still being read is flushed before it
+/// is reused.
+void
+cutVoice_(Voice_& v)
+{
+  if (v.job->tones) {
+    // Nothing was read ahead for it.
+    v.state = VoiceState_Idle;
+    retireJob_(v.job);
+    return;
+  }
+  if (v.seq.segment().clip >= 0)
+    clip_cache.release(v.seq.segment().clip);
+  v.seq.reset();
+  v.state = VoiceState_Flushing;
+  v.cancel.store(true, std::memory_order_release);
+  reader_thread.flags_set(kReaderStartFlag);
+}
+
+/// \brief Cut the voices whose jobs were cancelled, once they have faded out.
+/// A voice that is fully mixed ends at once.
+///
+/// \return true if the banks queued ahead should be mixed again, so that a cut
+/// or fade out is heard promptly.
+bool
+cancelVoices_(unsigned int consumed)
+{
+  bool remix = false;
+  for (Voice_& v : voices) {
+    if (!v.job || !v.job->cancel)
+      continue;
+    switch (v.state) {
+      case VoiceState_Playing:
+        if (v.job->cancel != kCancelNow && v.job->fade_out_ms) {
+          if (!v.fading_out) {
+            const long length = fadeLength_(v.job->fade_out_ms);
+            v.fade.start(0, length, curveOf_(v.job));
+            v.fading_out = true;
+            remix        = true;
+          }
+          // Once faded out, the banks ahead are already silent for it.
+          if (!v.fade.active())
+            cutVoice_(v);
+          break;
+        }
+        remix = true;
+        cutVoice_(v);
+        break;
+
+      case VoiceState_Starting:
+        remix = true;
+        cutVoice_(v);
+        break;
+
+      case VoiceState_Finishing:
+        if (static_cast<int>(v.end_bank - consumed) > 0) {
+          v.end_bank = consumed;
+          remix      = true;
+        }
+        break;
+
+      default:
+        break;
     }
   }
+  return remix;
+}
+
+/// \brief Drop what the reader thread sent ahead for the cut voices. A voice
+/// comes free, and its job is retired, once the end marker of its job is in.
+void
+flushVoices_()
+{
+  for (Voice_& v : voices) {
+    if (v.state != VoiceState_Flushing)
+      continue;
+    rb::Segment seg;
+    while (v.segments.read(&seg, 1)) {
+      if (seg.clip >= 0)
+        clip_cache.release(seg.clip);
+      if (seg.type == rb::Segment::Undefined) {
+        v.state = VoiceState_Idle;
+        retireJob_(v.job);
+        break;
+      }
+    }
+    // Nothing is streamed after the end marker, so once it is in the ring is
+    // left empty.
+    v.stream.consume(v.stream.size());
+    reader_thread.flags_set(kReaderSpaceFlag);
+  }
+}
+
+/// \brief Retire the voices whose last bank has played, and signal their jobs.
+void
+finishVoices_(unsigned int consumed)
+{
+  for (Voice_& v : voices) {
+    if (
+      v.state != VoiceState_Finishing ||
+      static_cast<int>(consumed - v.end_bank) < 0)
+      continue;
+    v.state = VoiceState_Idle;
+    retireJob_(v.job);
+  }
+}
+
+/// \brief Check if any voice still has samples to mix, or is being flushed.
+bool
+voicesActive_()
+{
+  for (const Voice_& v : voices)
+    if (
+      v.state == VoiceState_Starting || v.state == VoiceState_Playing ||
+      v.state == VoiceState_Flushing)
+      return true;
+  return false;
+}
+
+/// \brief Drop the banks queued ahead of the DAC, so that they are mixed again,
+/// and end the voices that were finishing in them with the banks kept.
+void
+rewind_(rb::BankRing& ring)
+{
+  if (!ring.rewind())
+    return;
+  const unsigned int produced = ring.produced();
+  for (Voice_& v : voices)
+    if (
+      v.state == VoiceState_Finishing &&
+      static_cast<int>(v.end_bank - produced) > 0)
+      v.end_bank = produced;
+}
+
+/// \brief Attenuation of a voice while a job of a higher class plays over it.
+constexpr unsigned int kDuckAttenuation = MUSIC_PLAYER_DUCK_ATTENUATION;
+static_assert(kDuckAttenuation <= 256, "Duck attenuation is out of range.");
+
+/// \brief Resample a voice to the bank rate and add it into a mix, with the
+/// gain of its job and its fade.
+///
+/// \param duck Further attenuation of the voice, in 1/256ths.
+/// \param ring The bank ring, with the bank being mixed.
+/// \param running Whether the DMA is playing the banks already.
+///
+/// \return Fetch_Ok if the voice has samples left, or why it has none.
+Fetch_
+mixVoice_(
+  Voice_&             v,
+  unsigned int        duck,
+  std::int32_t*       acc,
+  int                 count,
+  const rb::BankRing& ring,
+  bool                running)
+{
+  Fetch_ fetch = Fetch_Ok;
+  v.mixer.mix(
+    v.fade, rb::mixGain(v.job->attenuation, duck), acc, count, [&](int& s) {
+      // The reader thread and the bank interrupt both wake the wait.
+      while ((fetch = nextSample_(v, s)) == Fetch_Starved &&
+             (!running || !ring.due()))
+        osSignalWait(EVENT_FLAG_AUDIO_LOAD, osWaitForever);
+      return fetch == Fetch_Ok;
+    });
+  return fetch;
+}
+
+/// \brief Mix the voices into a bank. The oldest voice sets the rate of the
+/// bank, and the others are resampled to it. Voices of a lower class than the
+/// highest one playing are ducked. The sum is saturated rather than wrapped.
+///
+/// A voice the reader thread is behind on is waited for while the banks
+/// queued ahead of this one play, until the bank is due. Only then is it
+/// silent for the rest of the bank, and counted as a voice underrun. Before
+/// the banks start to play, nothing can underrun, so the initial fill waits
+/// for the voices for as long as it takes.
+///
+/// \param ring The bank ring, with the bank to mix.
+/// \param running Whether the DMA is playing the banks already.
+///
+/// \return true if a voice was starved in the bank.
+bool
+mixBank_(const rb::BankRing& ring, bool running)
+{
+  const unsigned int produced = ring.produced();
+  const int          bank     = ring.slot(produced);
+
+  Voice_* lead = nullptr;
+  int     top  = -1;
+  for (Voice_& v : voices) {
+    v.starved = false;
+    if (v.state != VoiceState_Playing)
+      continue;
+    top = std::max(top, classOf_(v.job));
+    if (!lead || static_cast<int>(v.order - lead->order) < 0)
+      lead = &v;
+  }
+  if (lead && lead->in_rate != mix_rate) {
+    mix_rate = lead->in_rate;
+    for (Voice_& v : voices)
+      if (v.state == VoiceState_Playing)
+        updateStep_(v);
+  }
+
+  const int      bank_len = bank_adapter.length();
+  Sample_* const buffer   = audio_buf[bank];
+  std::int32_t   acc[kMixChunk];
+  bool           starved  = false;
+  for (int done = 0; done < bank_len; done += kMixChunk) {
+    const int n = std::min(kMixChunk, bank_len - done);
+    std::fill(acc, acc + n, 0);
+    for (Voice_& v : voices) {
+      if (v.state != VoiceState_Playing || v.starved)
+        continue;
+      const unsigned int duck = classOf_(v.job) < top ? kDuckAttenuation : 0;
+      switch (mixVoice_(v, duck, acc, n, ring, running)) {
+        case Fetch_Starved:
+          v.starved = true;
+          starved   = true;
+          ++audio_stats.voice_underruns[&v - voices.data()];
+          break;
+
+        case Fetch_Ended:
+          v.state    = VoiceState_Finishing;
+          v.end_bank = produced + 1;
+          break;
+
+        default:
+          break;
+      }
+    }
+    rb::mixDown(acc, buffer + done, n);
+  }
+
+  bank_lli[bank].control(bankControl_(bank_len));
+  bank_cntval[bank] = static_cast<std::uint16_t>(dac_clock / mix_rate);
+  return starved;
+}
+
+/// \brief Play the voices through the bank ring until all of them are done.
+/// Jobs queued meanwhile join the mix as voices come free. Only ever run on the
+/// audio thread.
+void
+runSession_()
+{
+  static const int kClockFreq = configDACClock_();
+  dac_clock                   = kClockFreq;
+  startCycleCounter_();
+  const std::uint32_t cycles_per_us = SystemCoreClock / 1000000;
+  bank_adapter.restart();
+  audio_stats.bank_samples = bank_adapter.length();
+
+  rb::BankRing   ring(kBankCount);
+  MODDMA_Config  bank_conf;
+  DataCallback_  callback_d(osThreadGetId(), ring);
+  ErrorCallback_ callback_e;
+
+  // Fill initial buffer banks. Filling sets the size of each bank, so the ring
+  // has to be linked first.
+  linkBanks_();
+  while (voicesActive_() && !ring.full()) {
+    pollJobs_();
+    cancelVoices_(ring.consumed());
+    flushVoices_();
+    primeVoices_(ring.produced(), false);
+    mixBank_(ring, false);
+    ring.produce();
+  }
 
   debug("\r\n[MusicPlayer] Loaded initial banks.");
 
-  // Configure Banks
-  for (int i = 0; i < kBankCount; ++i) {
-    (&bank_conf[i])
-      ->srcMemAddr(reinterpret_cast<std::uint32_t>(&audio_buf[i]))
-      ->dstMemAddr(MODDMA::DAC)
-      ->transferSize(sizeof(audio_buf[i]) / sizeof(audio_buf[i][0]))
-      ->transferType(MODDMA::m2p)
-      ->dstConn(MODDMA::DAC)
-      ->attach_tc(&callback_d, &DataCallback_::operator())
-      ->attach_err(&callback_e, &ErrorCallback_::operator());
-  }
-  bank_conf[0].channelNum(MODDMA::Channel_0);
-  bank_conf[1].channelNum(MODDMA::Channel_1);
-
-  debug("\r\n[MusicPlayer] Configured initial banks.");
-
-  // Start DMA to DAC.
-  if (!DMA.Setup(&bank_conf[0])) {
+  // Configure bank ring. The channel starts on bank 0 and follows the LLIs from
+  // there on without stopping.
+  if (!voicesActive_())
+    bank_lli[ring.slot(ring.produced() - 1)].nextLLI(0);
+  bank_conf.channelNum(rb::kDmaAudio)
+    ->srcMemAddr(bank_lli[0].srcAddr())
+    ->dstMemAddr(MODDMA::DAC)
+    ->transferSize(kBankSize)
+    ->transferType(MODDMA::m2p)
+    ->dstConn(MODDMA::DAC)
+    ->dmaLLI(bank_lli[0].nextLLI())
+    ->attach_tc(&callback_d, &DataCallback_::operator())
+    ->attach_err(&callback_e, &ErrorCallback_::operator());
+
+  debug("\r\n[MusicPlayer] Configured bank ring.");
+
+  // Start DMA to DAC. Setup() assumes word transfers and a full bank, so the
+  // first bank gets the control word of its LLI.
+  if (!DMA.Setup(&bank_conf)) {
     error("[MusicPlayer] Error in initial DMA Setup()!");
-    goto end;
+    return;
   }
+  reinterpret_cast<LPC_GPDMACH_TypeDef*>(DMA.Channel_p(rb::kDmaAudio))
+    ->DMACCControl = bank_lli[0].control();
 
-  LPC_DAC->DACCNTVAL = static_cast<std::uint16_t>(
-    kClockFreq / initial_speed /
-    (file_info.rate ? file_info.rate : MUSIC_PLAYER_DEFAULT_PCM_RATE));
+  LPC_DAC->DACCNTVAL = bank_cntval[0];
   LPC_DAC->DACCTRL |= 0xC; // Start running DAC.
 
   debug("\r\n[MusicPlayer] DAC enabled.");
 
-  DMA.Enable(&bank_conf[0]);
+  DMA.Enable(&bank_conf);
 
   debug("\r\n[MusicPlayer] DMA enabled.");
 
-  // Start audio buffering loop.
+  // Start audio buffering loop. Voices join and leave here, while the banks of
+  // the others keep playing.
   debug("\r\n[MusicPlayer] Starting audio buffering idle loop.");
-  osSignalWait(EVENT_FLAG_AUDIO_LOAD, osWaitForever);
-  while (more) {
-    // debug("\r\n[MusicPlayer] Fetching more from file...");
-    int next_bank = (curr_bank - 1 + kBankCount) % kBankCount;
-    if (readBuffer_(file_info, more, audio_buf[next_bank])) {
-      error("[MusicPlayer] Error fetching more from file %s!", file_info.name);
-      goto end2;
+  unsigned int timed = 0; // Bank swap the refill time was last taken for.
+  while (voicesActive_()) {
+    pollJobs_();
+    bool remix = cancelVoices_(ring.consumed());
+    flushVoices_();
+    finishVoices_(ring.consumed());
+
+    // A voice cut or joining over the others is heard within a couple of bank
+    // periods, rather than after the whole ring.
+    remix |= primeVoices_(ring.produced(), true);
+    if (remix)
+      rewind_(ring);
+
+    if (ring.full()) {
+      osSignalWait(EVENT_FLAG_AUDIO_LOAD, osWaitForever);
+      continue;
+    }
+    // On an underrun the DMA is replaying a stale bank.
+    if (ring.resync())
+      ++audio_stats.underruns;
+
+    const int           next_bank = ring.slot(ring.produced());
+    const std::uint32_t mix_start = DWT->CYCCNT;
+    const bool          starved   = mixBank_(ring, true);
+    // The DAC counts on the CPU clock, so the refill is timed against it. A
+    // voice the card starved grows the banks, so the ring covers more of it.
+    bank_adapter.record(
+      DWT->CYCCNT - mix_start, dac_clock / mix_rate, starved);
+    audio_stats.bank_samples = bank_adapter.length();
+
+    // Time the first refill after each bank swap, from the interrupt on.
+    const unsigned int swaps = ring.consumed();
+    if (swaps != timed) {
+      timed = swaps;
+      const std::uint32_t cycles = DWT->CYCCNT - bank_done_cycles;
+      record_(audio_stats.refill_us, cycles / cycles_per_us);
     }
-    // debug(" done.");
+    if (ring.late())
+      ++audio_stats.late_refills;
+    // Terminate the ring after the final bank so the channel stops by itself.
+    if (!voicesActive_())
+      bank_lli[next_bank].nextLLI(0);
+    ring.produce();
+  }
+
+  // Drain the remaining banks.
+  while (ring.ahead() > 0) {
+    finishVoices_(ring.consumed());
     osSignalWait(EVENT_FLAG_AUDIO_LOAD, osWaitForever);
   }
   debug("\r\n[MusicPlayer] Finished playing audio.");
 
-end2:
   LPC_DAC->DACCTRL &= ~(0xC); // Stop running DAC.
-  DMA.Disable(MODDMA::Channel_0);
-  DMA.Disable(MODDMA::Channel_1);
-end:
-  deinitFile_(file_info);
+  DMA.Disable(rb::kDmaAudio);
+  finishVoices_(ring.consumed());
+
+  if (kPrintStats)
+    printStats_();
+}
+
+/// \brief Flag set on a blocking caller's EventFlags when its job is done.
+constexpr std::uint32_t kJobDoneFlag = 0x1;
+
+void
+audioThread_()
+{
+  if (reader_thread.start(readerThread_) != osOK)
+    error("[MusicPlayer] Cannot start reader thread!");
+
+  while (true) {
+    MusicPlayerJob* job;
+    if (!takeJob_(job, rtos::Kernel::wait_for_u32_forever))
+      continue;
+
+    startVoice_(voices[0], job);
+    runSession_();
+  }
+}
+
+/// \brief Hand a job over to the audio thread, starting it if needed.
+///
+/// \return 0 on success, 1 if the job is in flight or the queue stayed full.
+int
+queueJob_(MusicPlayerJob* job, rtos::Kernel::Clock::duration_u32 timeout)
+{
+  static const bool kStarted = audio_thread.start(audioThread_) == osOK;
+  if (!kStarted)
+    error("[MusicPlayer] Cannot start audio thread!");
+
+  if (
+    job->state == MusicPlayerJob_Queued || job->state == MusicPlayerJob_Playing)
+    return 1;
+
+  job->state      = MusicPlayerJob_Queued;
+  job->cancel     = 0;
+  const int klass = classOf_(job);
+  ++queued[klass];
+  if (!jobs.try_put_for(timeout, job, klass)) {
+    --queued[klass];
+    job->state = MusicPlayerJob_Idle;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+extern "C" void
+playMusic(const char* file_name, double initial_speed)
+{
+  playSequence(&file_name, 1, initial_speed);
+}
+
+extern "C" void
+playSequence(const char* const* file_names, int count, double initial_speed)
+{
+  rtos::EventFlags done_flags;
+  MusicPlayerJob   job = {};
+  job.file_names       = file_names;
+  job.count            = count;
+  job.speed            = initial_speed;
+  job.context          = &done_flags;
+  job.done             = [](MusicPlayerJob* j) {
+    static_cast<rtos::EventFlags*>(j->context)->set(kJobDoneFlag);
+  };
+
+  queueJob_(&job, rtos::Kernel::wait_for_u32_forever);
+  done_flags.wait_any(kJobDoneFlag);
+}
+
+extern "C" int
+playSequenceAsync(MusicPlayerJob* job)
+{
+  return queueJob_(job, 0ms);
+}
+
+void
+musicPlayerUseBlockDevice(rb::FatVolume* volume, mbed::BlockDevice* device)
+{
+  fat_volume   = volume;
+  block_device = device;
+}
+
+extern "C" void
+musicPlayerStats(MusicPlayerStats* stats)
+{
+  *stats = audio_stats;
+}
+
+extern "C" void
+musicPlayerResetStats()
+{
+  audio_stats = {};
+}
+
+extern "C" void
+musicPlayerCancel(MusicPlayerJob* job)
+{
+  job->cancel = 1;
+  osSignalSet(audio_thread.get_id(), EVENT_FLAG_AUDIO_LOAD);
+}
+
+extern "C" void
+musicPlayerCacheStats(MusicPlayerCacheStats* stats)
+{
+  const rb::ClipCache::Stats cache = clip_cache.stats();
+  stats->hits                      = cache.hits;
+  stats->misses                    = cache.misses;
+  stats->evictions                 = cache.evictions;
+  stats->used                      = cache.used;
+  stats->capacity                  = clip_cache.capacity();
 }
@@ -9,10 +9,202 @@
 
 // ======================= Public Interface ==========================
 
+namespace mbed {
+class BlockDevice;
+} // namespace mbed
+
+namespace rb {
+class FatVolume;
+} // namespace rb
+
+// clang-format off
+/// \brief State of an asynchronous playback job.
+enum MusicPlayerJobState
+{
+  MusicPlayerJob_Idle      = 0
+, MusicPlayerJob_Queued    = 1
+, MusicPlayerJob_Playing   = 2
+, MusicPlayerJob_Done      = 3
+, MusicPlayerJob_Cancelled = 4 // Stopped early by musicPlayerCancel().
+};
+
+/// \brief Shape of a job's fades.
+enum MusicPlayerFadeCurve
+{
+  MusicPlayerFade_Linear      = 0 // Straight line in amplitude.
+, MusicPlayerFade_Exponential = 1 // Straight line in decibels, from -48 dB.
+};
+
+/// \brief Priority class of a playback job. A job of a higher class takes a
+/// voice from one of a lower class when none is free, and ducks the lower ones
+/// it plays over.
+enum MusicPlayerPriority
+{
+  MusicPlayerPriority_Ambient      = 0
+, MusicPlayerPriority_Announcement = 1
+, MusicPlayerPriority_Alarm        = 2
+};
+// clang-format on
+
+/// \brief One tone of a synthesized pattern.
+struct MusicPlayerTone
+{
+  /// \brief Frequency at the start of the tone. 0 on both ends is a rest.
+  unsigned short start_hz;
+
+  /// \brief Frequency at the end of the tone, swept linearly from the start.
+  unsigned short end_hz;
+
+  /// \brief Length of the tone, including its fades.
+  unsigned short duration_ms;
+
+  /// \brief Length of the linear fade in.
+  unsigned short attack_ms;
+
+  /// \brief Length of the linear fade out.
+  unsigned short release_ms;
+
+  /// \brief Peak amplitude in 1/256ths of full scale.
+  unsigned short level;
+};
+
+/// \brief An asynchronous playback job.
+///
+/// The job is owned by the caller. It, along with the file names it points to,
+/// must stay alive until it is done. A done job may be submitted again.
+struct MusicPlayerJob
+{
+  /// \brief The names of the files to play, in order.
+  const char* const* file_names;
+
+  /// \brief Tones to synthesize in order, instead of playing files. A tone
+  /// job never touches the card, so it plays even without one. May be null.
+  const struct MusicPlayerTone* tones;
+
+  /// \brief The number of files, or of tones.
+  int count;
+
+  /// \brief The initial speed of the music player.
+  double speed;
+
+  /// \brief Volume reduction in 1/256ths of full scale: 0 plays at full volume
+  /// and 256 is silent. Read on every bank, so it can be changed while the job
+  /// plays, e.g. to duck music under speech.
+  volatile unsigned int attenuation;
+
+  /// \brief Length of the fade in from silence when the job starts, e.g. for a
+  /// gradual wake-up alarm. 0 starts at full volume.
+  unsigned short fade_in_ms;
+
+  /// \brief Length of the fade out when the job is cancelled with
+  /// musicPlayerCancel(). 0 cuts it at once. A job preempted by a higher class
+  /// is always cut at once.
+  unsigned short fade_out_ms;
+
+  /// \brief One of MusicPlayerFadeCurve, for both fades.
+  int fade_curve;
+
+  /// \brief One of MusicPlayerPriority. Queued jobs start in order of priority,
+  /// then of submission.
+  int priority;
+
+  /// \brief Called from the audio thread once the job is done. May be null.
+  /// Must not block, since no bank is refilled until it returns.
+  void (*done)(struct MusicPlayerJob* job);
+
+  /// \brief Free for use by the caller, e.g. for the done callback.
+  void* context;
+
+  /// \brief Set by musicPlayerCancel(). Managed by the player.
+  volatile int cancel;
+
+  /// \brief One of MusicPlayerJobState. Managed by the player, zero-initialize
+  /// before first use.
+  volatile int state;
+};
+
+/// \brief Statistics of the in-memory clip cache.
+struct MusicPlayerCacheStats
+{
+  /// \brief Number of clips served from memory.
+  unsigned int hits;
+
+  /// \brief Number of clips that had to be read from the card.
+  unsigned int misses;
+
+  /// \brief Number of clips dropped to make room for others.
+  unsigned int evictions;
+
+  /// \brief Bytes of the cache in use.
+  unsigned int used;
+
+  /// \brief Total bytes of the cache.
+  unsigned int capacity;
+};
+
+/// \brief Number of buckets of a MusicPlayerHistogram.
+enum
+{
+  MusicPlayerHistogram_Buckets = 16
+};
+
+/// \brief A histogram of values in power of two buckets.
+struct MusicPlayerHistogram
+{
+  /// \brief Bucket 0 counts the values 0 and 1, and bucket i the values in
+  /// [2^i, 2^(i+1)). The last bucket also counts everything above.
+  unsigned int buckets[MusicPlayerHistogram_Buckets];
+
+  /// \brief Number of values.
+  unsigned int count;
+
+  /// \brief Largest value.
+  unsigned int max;
+};
+
+/// \brief Statistics of the audio path, for tuning the bank size and card
+/// clock from data.
+struct MusicPlayerStats
+{
+  /// \brief Microseconds from a bank finishing to the next refill completing.
+  struct MusicPlayerHistogram refill_us;
+
+  /// \brief Bytes per card read.
+  struct MusicPlayerHistogram read_bytes;
+
+  /// \brief CPU cycles spent in the bank interrupt.
+  struct MusicPlayerHistogram isr_cycles;
+
+  /// \brief Number of banks played.
+  unsigned int banks;
+
+  /// \brief Samples per bank, as last adapted to the refills.
+  unsigned int bank_samples;
+
+  /// \brief Number of refills that finished after the DMA had already moved
+  /// on to the bank, so that it played stale samples.
+  unsigned int late_refills;
+
+  /// \brief Number of times the DMA caught up with the refills, and the ring
+  /// was resynchronized.
+  unsigned int underruns;
+
+  /// \brief Number of banks each voice was cut short in, silent for the rest
+  /// of the bank because the reader thread was behind on it.
+  unsigned int voice_underruns[MUSIC_PLAYER_VOICE_COUNT];
+};
+
 /// \brief Play the music file at the given speed.
 ///
-/// The function is non-reentrant, as such a mutex is used to ensure unique
-/// access. Calling thread will block until the music is done playing.
+/// Files ending in .wav are parsed as RIFF/WAVE, which may hold 8-bit or 16-bit
+/// PCM, mono or stereo (mixed down), or mono IMA ADPCM at a quarter of the size
+/// of 16-bit PCM, at any rate the DAC can keep up with. Any other file is raw
+/// 8-bit unsigned PCM at MUSIC_PLAYER_DEFAULT_PCM_RATE.
+///
+/// Playback is run on the audio thread, which mixes up to
+/// MUSIC_PLAYER_VOICE_COUNT calls from several threads at once, e.g. speech
+/// over music. Further calls wait for a voice to come free, in order. Calling
+/// thread will block until the music is done playing.
 ///
 /// \note As the sampling frequency of the file increases, the time drift of the
 /// music player is delayed. It will play notes at their correct frequencies and
@@ -24,6 +216,92 @@
 extern "C" void
 playMusic(const char* file_name, double initial_speed);
 
+/// \brief Play a list of music files back to back at the given speed.
+///
+/// All files are streamed through a single DMA session, so the DAC keeps
+/// running across file boundaries and there is no gap between clips. The next
+/// file is opened and buffered while the previous one is still draining. Each
+/// file plays at its own sample rate, resampled to that of the oldest voice
+/// when mixed with others.
+///
+/// Same blocking behaviour as playMusic(). Must not be called from a job's done
+/// callback.
+///
+/// \param file_names The names of the files to play, in order.
+/// \param count The number of files.
+/// \param initial_speed The initial speed of the music player.
+extern "C" void
+playSequence(const char* const* file_names, int count, double initial_speed);
+
+/// \brief Queue a job on the audio thread and return at once.
+///
+/// The job is mixed with the ones already playing as soon as a voice is free.
+/// If none is, and the job is of a higher priority class than one of them, that
+/// one is cancelled to make room. Either way a job that outranks everything
+/// playing is heard within a couple of bank periods: the banks queued ahead of
+/// the DAC are mixed again with it, at the cost of a short skip in the others.
+///
+/// Completion is reported through the job's done callback, and its state can be
+/// polled at any time.
+///
+/// \param job The job to play. Must not already be queued or playing.
+///
+/// \return 0 if the job was queued, 1 if it is in flight or the queue is full.
+extern "C" int
+playSequenceAsync(struct MusicPlayerJob* job);
+
+/// \brief Cancel a job, queued or playing.
+///
+/// A playing job starts to fade out, or is cut, within a couple of bank
+/// periods. See MusicPlayerJob::fade_out_ms. The job then ends as
+/// MusicPlayerJob_Cancelled, and its done callback is called as usual. Does
+/// nothing to a job that is already done.
+///
+/// Safe to call from any thread or from an ISR.
+///
+/// \param job The job to cancel.
+extern "C" void
+musicPlayerCancel(struct MusicPlayerJob* job);
+
+/// \brief Get the statistics of the in-memory clip cache.
+///
+/// Small clips are kept in a least recently used cache after they are first
+/// played, and later plays are served from memory without touching the card.
+///
+/// \param stats Filled with the current statistics.
+extern "C" void
+musicPlayerCacheStats(struct MusicPlayerCacheStats* stats);
+
+/// \brief Let the player read files straight from the card.
+///
+/// Streamed files and the sound pack then have their cluster chains resolved
+/// once when opened, and are read from the block device with multi-block reads
+/// that never touch the filesystem. Files too fragmented to map are still read
+/// through the filesystem.
+///
+/// Must be called before the first playback, with the filesystem mounted.
+/// Mapping a file takes the lock of the filesystem, so the volume may still be
+/// used from other threads during playback.
+///
+/// \param volume Filesystem mounted at AUX_MOUNT_POINT.
+/// \param device Block device the filesystem is mounted on.
+void
+musicPlayerUseBlockDevice(rb::FatVolume* volume, mbed::BlockDevice* device);
+
+/// \brief Get the statistics of the audio path, gathered since the last reset.
+///
+/// They are also printed whenever the player goes idle in the debug profile,
+/// or if MUSIC_PLAYER_PRINT_STATS is set.
+///
+/// \param stats Filled with the current statistics. Gathered without locking,
+/// so a snapshot taken while playing may be slightly inconsistent.
+extern "C" void
+musicPlayerStats(struct MusicPlayerStats* stats);
+
+/// \brief Reset the statistics of the audio path.
+extern "C" void
+musicPlayerResetStats(void);
+
 // ===================== Detail Implementation =======================
 
 #endif // MUSIC_PLAYER_H
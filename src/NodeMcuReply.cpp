@@ -0,0 +1,77 @@
+/// \file NodeMcuReply.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Parser of the replies of the NodeMCU REPL on the wifi module.
+
+#include "NodeMcuReply.hpp"
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+bool
+NodeMcuReply::feed(char c)
+{
+  if (json) {
+    if (c == '{')
+      ++depth;
+    if (depth > 0)
+      put(c);
+    if (c == '}' && depth > 0 && --depth == 0)
+      return finish();
+    return false;
+  }
+
+  switch (state) {
+    case Echo:
+      if (c == '\n')
+        state = LineStart;
+      return false;
+    case LineStart:
+      if (c == '>' && !marker) {
+        state = Prompt;
+        return false;
+      }
+      state = Line;
+      break;
+    case Prompt:
+      if (c == ' ')
+        return finish();
+      if (c == '>')
+        return false;
+      // A '>' that started an output line, not the prompt.
+      put('>');
+      state = Line;
+      break;
+    case Line:
+      break;
+    case Done:
+      return true;
+  }
+
+  if (c == '\r')
+    return false;
+  if (c != '\n') {
+    put(c);
+    if (marker && match_length <= kMaxMarker)
+      match[match_length++] = c;
+    return false;
+  }
+  const bool end = marker && match_length == marker_length &&
+                   std::memcmp(match, marker, match_length) == 0;
+  match_length = 0;
+  if (end) {
+    if (resp) {
+      length       = line;
+      resp[length] = '\0';
+    }
+    return finish();
+  }
+  put('\n');
+  line  = length;
+  state = LineStart;
+  return false;
+}
+
+} // namespace rb
@@ -0,0 +1,126 @@
+/// \file NodeMcuReply.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Parser of the replies of the NodeMCU REPL on the wifi module.
+
+#ifndef RB_NODEMCU_REPLY_HPP
+#define RB_NODEMCU_REPLY_HPP
+
+#ifndef __cplusplus
+#error "NodeMcuReply.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstddef>
+#include <cstring>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Tracks the reply to a command on the NodeMCU REPL, one byte at a
+/// time.
+///
+/// The REPL echoes the command line, prints the output of the command, and
+/// then the prompt "> " (or ">> " inside an unfinished block) at the start of
+/// a line. Output printed later by callbacks has no prompt after it, and ends
+/// with a marker line or a complete JSON object instead.
+struct NodeMcuReply
+{
+  // clang-format off
+  /// \brief Where the reply is at.
+  enum State
+  {
+    Echo      = 0 // Inside the echo of the command line.
+  , LineStart = 1 // At the start of an output line, which may be the prompt.
+  , Line      = 2 // Inside an output line.
+  , Prompt    = 3 // Past a '>' at the start of a line.
+  , Done      = 4 // Complete.
+  };
+  // clang-format on
+
+  /// \brief Longest marker line.
+  static constexpr int kMaxMarker = 23;
+
+  /// \brief Constructor.
+  ///
+  /// \param resp optional buffer for the output
+  /// \param size size of resp, including the terminator
+  /// \param state where the reply starts
+  /// \param marker line that ends the reply instead of the prompt, or null.
+  /// At most kMaxMarker characters.
+  /// \param json whether the reply is a JSON object instead of lines
+  NodeMcuReply(
+    char*       resp,
+    int         size,
+    State       state,
+    const char* marker = nullptr,
+    bool        json   = false) :
+      resp(size > 0 ? resp : nullptr),
+      size(size),
+      state(state),
+      marker(marker),
+      marker_length(marker ? static_cast<int>(std::strlen(marker)) : 0),
+      json(json)
+  {
+    if (this->resp)
+      this->resp[0] = '\0';
+  }
+
+  /// \brief Take the next byte from the module.
+  ///
+  /// \return true once the reply is complete
+  bool feed(char c);
+
+  /// \brief Take bytes from the module, up to the end of the reply.
+  ///
+  /// \return The number of bytes taken, short of count only if the reply is
+  /// complete.
+  std::size_t feed(const char* data, std::size_t count)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      if (feed(data[i]))
+        return i + 1;
+    return count;
+  }
+
+  char*       resp;
+  int         size;
+  int         length = 0; // Bytes of output in resp.
+  int         line   = 0; // Where the current line starts in resp.
+  int         depth  = 0; // Depth of braces in a JSON reply.
+  State       state;
+  const char* marker;
+  int         marker_length;
+  bool        json;
+
+  // Start of the current line, to hold against the marker whether or not the
+  // output is kept, and one byte more to tell a longer line apart.
+  char match[kMaxMarker + 1];
+  int  match_length = 0;
+
+ private:
+  /// \brief Append to the output, dropping what does not fit.
+  void put(char c)
+  {
+    if (resp && length < size - 1) {
+      resp[length++] = c;
+      resp[length]   = '\0';
+    }
+  }
+
+  /// \brief Finish the reply, without the line break after the last line.
+  bool finish()
+  {
+    if (resp && length > 0 && resp[length - 1] == '\n')
+      resp[--length] = '\0';
+    state = Done;
+    return true;
+  }
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_NODEMCU_REPLY_HPP
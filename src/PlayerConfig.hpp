@@ -0,0 +1,84 @@
+/// \file PlayerConfig.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Sizes of the MusicPlayer, from the MusicPlayer settings of
+/// mbed_app.json.
+///
+/// \details Shared by the firmware and the host tests. The host build takes the
+/// same settings out of mbed_app.json, so that the simulator runs the player at
+/// the sizes of the board.
+
+#ifndef RB_PLAYER_CONFIG_HPP
+#define RB_PLAYER_CONFIG_HPP
+
+#ifndef __cplusplus
+#error "PlayerConfig.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#ifndef MUSIC_PLAYER_AUDIO_BUF_BANK_COUNT
+#error "PlayerConfig.hpp needs the MusicPlayer settings of mbed_app.json."
+#endif // MUSIC_PLAYER_AUDIO_BUF_BANK_COUNT
+
+#include <cstddef>
+#include <cstdint>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+namespace player {
+
+/// \brief The number of banks of audio data in the DMA ring.
+constexpr int kBankCount = MUSIC_PLAYER_AUDIO_BUF_BANK_COUNT;
+static_assert(kBankCount >= 2, "DMA ring needs at least two banks");
+
+/// \brief The largest number of samples in each bank, as allocated.
+constexpr int kBankSize = MUSIC_PLAYER_AUDIO_BUF_BANK_SIZE;
+static_assert(kBankSize > 0 && kBankSize <= 0xFFF, "GPDMA transfer size limit");
+
+/// \brief The smallest number of samples a bank is shrunk to at runtime.
+constexpr int kMinBankSize = MUSIC_PLAYER_MIN_BANK_SIZE;
+static_assert(
+  kMinBankSize > 0 && kMinBankSize <= kBankSize,
+  "Minimum bank size out of range");
+
+#if MUSIC_PLAYER_COMPACT_BANKS
+/// \brief A DAC sample as moved into DACR by the DMA. Only bits 15:6 (VALUE)
+/// carry data, so halfword transfers are enough and halve the bank memory.
+using Sample = std::uint16_t;
+#else
+/// \brief A DAC sample as moved into DACR by the DMA.
+using Sample = std::uint32_t;
+#endif
+
+/// \brief The number of voices that can play at once.
+constexpr int kVoiceCount = MUSIC_PLAYER_VOICE_COUNT;
+static_assert(kVoiceCount >= 1, "Mixer needs at least one voice");
+
+/// \brief Size of the stream rings of all the voices in bytes.
+constexpr std::size_t kStreamRingSize = MUSIC_PLAYER_STREAM_RING_SIZE;
+
+/// \brief Size of the stream ring of each voice in bytes.
+constexpr std::size_t kStreamSize = kStreamRingSize / kVoiceCount;
+static_assert(
+  kStreamSize && (kStreamSize & (kStreamSize - 1)) == 0,
+  "Stream ring size per voice must be a power of two");
+
+/// \brief Maximum number of bytes to read at once into a stream ring.
+constexpr std::size_t kStreamReadSize = MUSIC_PLAYER_STREAM_READ_SIZE;
+
+/// \brief Sample rate of raw PCM, which carries no header.
+constexpr int kDefaultRate = MUSIC_PLAYER_DEFAULT_PCM_RATE;
+
+/// \brief Number of samples decoded from a voice at once, ahead of mixing.
+constexpr int kVoiceChunk = 32;
+
+/// \brief Number of samples mixed at once.
+constexpr int kMixChunk = 32;
+
+} // namespace player
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_PLAYER_CONFIG_HPP
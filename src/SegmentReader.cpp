@@ -0,0 +1,124 @@
+/// \file SegmentReader.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Decoding of the MusicPlayer's segments of sample data.
+
+#include "SegmentReader.hpp"
+
+#include <algorithm>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+int
+SegmentReader::read(player::Sample* buffer, int count)
+{
+  switch (_seg.type) {
+    case Segment::U8Pcm:
+      return readPcm<8, 1>(buffer, count);
+
+    case Segment::Wav:
+      if (_seg.bits == 8)
+        return _seg.channels == 1 ? readPcm<8, 1>(buffer, count)
+                                  : readPcm<8, 2>(buffer, count);
+      return _seg.channels == 1 ? readPcm<16, 1>(buffer, count)
+                                : readPcm<16, 2>(buffer, count);
+
+    case Segment::Adpcm:
+      return readAdpcm(buffer, count);
+
+    default:
+      return -1;
+  }
+}
+
+int
+SegmentReader::readData(std::uint8_t* data, int count, int unit)
+{
+  int read_ct;
+  if (_seg.clip >= 0) {
+    read_ct = _cache->read(_seg.clip, _seg.size - _left, data, count);
+  } else {
+    count   = std::min<std::size_t>(count, _stream->size() / unit * unit);
+    read_ct = _stream->read(data, count);
+  }
+  _left -= read_ct;
+  return read_ct;
+}
+
+template<int Bits, int Channels>
+int
+SegmentReader::readPcm(player::Sample* buffer, int count)
+{
+  constexpr int kFrame = Bits / 8 * Channels;
+
+  // The raw frames are read into the buffer itself, so only read as many as
+  // fit in it.
+  count = std::min<long>(
+    {count, count * static_cast<long>(sizeof(player::Sample)) / kFrame,
+     _left / kFrame});
+
+  std::uint8_t* raw     = reinterpret_cast<std::uint8_t*>(buffer);
+  const int     read_ct = readData(raw, count * kFrame, kFrame) / kFrame;
+  convertPcm<Bits, Channels>(buffer, read_ct);
+  return read_ct;
+}
+
+// Each block starts with a header holding the first sample and the decoder
+// state, followed by two samples per byte, low nibble first.
+int
+SegmentReader::readAdpcm(player::Sample* buffer, int count)
+{
+  int out = 0;
+
+  if (_pending >= 0 && count > 0) {
+    buffer[out++] = _decoder.nibble(_pending);
+    _pending      = -1;
+  }
+
+  std::uint8_t raw[32];
+  while (out < count && _left > 0) {
+    const int in_block = (_seg.size - _left) % _seg.block;
+
+    if (in_block == 0) {
+      const int header = std::min<long>(ImaAdpcm::kHeaderSize, _left);
+      if (!readData(raw, header, header))
+        break;
+      if (header < ImaAdpcm::kHeaderSize)
+        continue; // Truncated block, nothing to decode.
+      buffer[out++] = _decoder.header(raw);
+      continue;
+    }
+
+    // A lone slot left in the buffer still takes a whole byte, and the second
+    // nibble waits for the next read.
+    const int n = readData(
+      raw,
+      std::min<long>(
+        {static_cast<long>(sizeof(raw)),
+         (count - out + 1) / 2,
+         _seg.block - in_block,
+         _left}),
+      1);
+    if (!n)
+      break;
+    for (int i = 0; i < n; ++i) {
+      buffer[out++] = _decoder.nibble(raw[i] & 0xF);
+      if (out == count)
+        _pending = raw[i] >> 4;
+      else
+        buffer[out++] = _decoder.nibble(raw[i] >> 4);
+    }
+  }
+  return out;
+}
+
+} // namespace rb
@@ -0,0 +1,131 @@
+/// \file SegmentReader.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Decoding of the MusicPlayer's segments of sample data, out of a
+/// voice's stream ring or the clip cache, into DAC samples.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// AudioFormat.hpp, so that the simulator of the player decodes with it too.
+
+#ifndef RB_SEGMENT_READER_HPP
+#define RB_SEGMENT_READER_HPP
+
+#ifndef __cplusplus
+#error "SegmentReader.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+
+#include "AudioFormat.hpp"
+#include "ClipCache.hpp"
+#include "PlayerConfig.hpp"
+#include "SpscRing.hpp"
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief A file's worth of sample data, either in the stream ring or in the
+/// clip cache.
+struct Segment
+{
+  // clang-format off
+  /// \brief Format of the sample data.
+  enum Type
+  {
+    Undefined = 0 // No data. Ends the segments of a job.
+  , U8Pcm     = 1 // Raw 8-bit unsigned PCM.
+  , Wav       = 2 // 8-bit unsigned or 16-bit signed PCM.
+  , Adpcm     = 3 // Mono IMA ADPCM.
+  };
+  // clang-format on
+
+  Type type;
+  int  rate;     // Samples per second, or 0 for the default rate.
+  int  bits;     // Bits per sample.
+  int  channels; // Mixed down to mono on playback.
+  int  block;    // Bytes per frame, or per block of compressed frames.
+  long size;     // Bytes of sample data in this segment.
+  int  clip;     // Pinned clip cache entry holding the data, or -1.
+};
+
+/// \brief The audio thread's side of a voice's segments, decoded back to back.
+///
+/// The decoder state is kept from one read to the next, so decoding resumes
+/// anywhere in a frame or an ADPCM block, whatever the reader thread has
+/// handed over so far.
+class SegmentReader
+{
+ public:
+  /// \brief Constructor. Nothing is being read.
+  ///
+  /// \param stream Stream ring the segments not in the clip cache are in.
+  /// \param cache Clip cache the other segments are in.
+  SegmentReader(SpscRing<std::uint8_t>* stream, const ClipCache* cache) :
+      _stream(stream),
+      _cache(cache)
+  {
+    reset();
+  }
+
+  /// \brief Get the segment being read.
+  const Segment& segment() const { return _seg; }
+
+  /// \brief Check if all of the segment has been read, so the next one can be
+  /// started.
+  bool done() const { return _left == 0 && _pending < 0; }
+
+  /// \brief Start reading a segment. The last one has to be done.
+  void start(const Segment& seg)
+  {
+    _seg  = seg;
+    _left = seg.size;
+  }
+
+  /// \brief Drop what is left of the segment and the decoder state. The clip
+  /// of the segment is left for the caller to release.
+  void reset()
+  {
+    _seg     = {Segment::Undefined, 0, 0, 0, 0, 0, -1};
+    _left    = 0;
+    _decoder = ImaAdpcm();
+    _pending = -1;
+  }
+
+  /// \brief Read samples from the segment, advancing through it.
+  ///
+  /// \param count The maximum number of samples to read.
+  ///
+  /// \return The number of samples read, limited by the data available in the
+  /// stream ring, or -1 on an unknown format.
+  int read(player::Sample* buffer, int count);
+
+ private:
+  /// \brief Read the data of the segment.
+  ///
+  /// \param unit Only whole multiples of this many bytes are read.
+  ///
+  /// \return The number of bytes read.
+  int readData(std::uint8_t* data, int count, int unit);
+
+  /// \brief Read PCM frames, converting them in place.
+  template<int Bits, int Channels>
+  int readPcm(player::Sample* buffer, int count);
+
+  /// \brief Decode IMA ADPCM.
+  int readAdpcm(player::Sample* buffer, int count);
+
+  SpscRing<std::uint8_t>* _stream;
+  const ClipCache*        _cache;
+  Segment                 _seg;
+  long                    _left; // Bytes of the segment left.
+  ImaAdpcm                _decoder;
+  int                     _pending; // Nibble kept for the next read, or -1.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_SEGMENT_READER_HPP
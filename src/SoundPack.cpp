@@ -0,0 +1,123 @@
+/// \file SoundPack.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Reader for indexed single-file sound packs.
+
+#include "SoundPack.hpp"
+
+#include <cstring>
+#include <new>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief On-card header of a pack.
+struct Header_
+{
+  char          magic[4];
+  std::uint16_t version;
+  std::uint16_t count;
+  std::uint32_t align;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(Header_) == 16, "Sound pack header layout");
+static_assert(sizeof(rb::SoundPack::Entry) == 48, "Sound pack entry layout");
+
+constexpr char          kMagic[4] = {'R', 'B', 'S', 'P'};
+constexpr std::uint16_t kVersion  = 1;
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+SoundPack::SoundPack() : _file(nullptr), _count(0), _root{0} {}
+
+SoundPack::~SoundPack()
+{
+  close();
+}
+
+bool
+SoundPack::open(const char* path)
+{
+  close();
+
+  const char* slash = std::strrchr(path, '/');
+  const int   root  = slash ? slash - path + 1 : 0;
+  if (root >= static_cast<int>(sizeof(_root)))
+    return false;
+
+  _file = std::fopen(path, "rb");
+  if (!_file)
+    return false;
+  // Clip data may be read through the handle under the file, behind the back
+  // of stdio. Without a buffer, stdio never trusts a stale file position.
+  std::setvbuf(_file, nullptr, _IONBF, 0);
+
+  Header_ header;
+  if (
+    std::fread(&header, sizeof(header), 1, _file) != 1 ||
+    std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+    header.version != kVersion) {
+    close();
+    return false;
+  }
+
+  _index.reset(new (std::nothrow) Entry[header.count]);
+  if (
+    !_index ||
+    std::fread(_index.get(), sizeof(Entry), header.count, _file) !=
+      header.count) {
+    close();
+    return false;
+  }
+  _count = header.count;
+
+  std::memcpy(_root, path, root);
+  _root[root] = '\0';
+  return true;
+}
+
+void
+SoundPack::close()
+{
+  if (_file)
+    std::fclose(_file);
+  _file = nullptr;
+  _index.reset();
+  _count = 0;
+}
+
+const SoundPack::Entry*
+SoundPack::find(const char* path) const
+{
+  if (!_file)
+    return nullptr;
+
+  const std::size_t root = std::strlen(_root);
+  if (std::strncmp(path, _root, root) != 0)
+    return nullptr;
+  const char* name = path + root;
+
+  // Index is sorted by name.
+  int lo = 0;
+  int hi = _count - 1;
+  while (lo <= hi) {
+    const int mid = lo + (hi - lo) / 2;
+    const int cmp = std::strncmp(name, _index[mid].name, kNameSize);
+    if (cmp == 0)
+      return &_index[mid];
+    if (cmp < 0)
+      hi = mid - 1;
+    else
+      lo = mid + 1;
+  }
+  return nullptr;
+}
+
+} // namespace rb
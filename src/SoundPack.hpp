@@ -0,0 +1,90 @@
+/// \file SoundPack.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Reader for indexed single-file sound packs.
+///
+/// \details A sound pack bundles a directory of clips into one file, so that
+/// playing a clip is a seek within an already open file instead of a directory
+/// walk and cluster chain lookup per clip. Packs are built on the host with
+/// tools/mkpack.py. Layout, all integers little-endian:
+///
+///   Header  magic "RBSP", u16 version, u16 count, u32 align, u32 reserved
+///   Index   count x {char name[40], u32 offset, u32 size}, sorted by name
+///   Payload clips stored verbatim, each starting on a multiple of align
+///
+/// Names are the clip paths relative to the directory holding the pack.
+
+#ifndef RB_SOUND_PACK_HPP
+#define RB_SOUND_PACK_HPP
+
+#ifndef __cplusplus
+#error "SoundPack.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief An open sound pack.
+class SoundPack
+{
+ public:
+  /// \brief Maximum length of a clip name, including the terminator.
+  static constexpr int kNameSize = 40;
+
+  /// \brief Index entry of a clip.
+  struct Entry
+  {
+    char          name[kNameSize];
+    std::uint32_t offset; // From the start of the pack.
+    std::uint32_t size;
+  };
+
+  SoundPack();
+  ~SoundPack();
+
+  SoundPack(const SoundPack&) = delete;
+  SoundPack& operator=(const SoundPack&) = delete;
+
+  /// \brief Open a pack and load its index.
+  ///
+  /// \param path Path of the pack. Clips are looked up relative to its
+  /// directory.
+  ///
+  /// \return true if successful
+  bool open(const char* path);
+
+  /// \brief Close the pack.
+  void close();
+
+  /// \brief Check if a pack is open.
+  bool is_open() const { return _file != nullptr; }
+
+  /// \brief Look up a clip.
+  ///
+  /// \param path Full path of the clip, as if it was not packed.
+  ///
+  /// \return The entry of the clip, or null if it is not in the pack.
+  const Entry* find(const char* path) const;
+
+  /// \brief The pack file. Seek to an entry's offset to read the clip. It is
+  /// unbuffered, so it may also be read through its handle.
+  std::FILE* file() const { return _file; }
+
+ private:
+  std::FILE*               _file;
+  std::unique_ptr<Entry[]> _index;
+  int                      _count;
+  char                     _root[64]; // Directory of the pack, with the '/'.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_SOUND_PACK_HPP
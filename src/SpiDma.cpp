@@ -0,0 +1,201 @@
+/// \file SpiDma.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief DMA block transfers for an SPI bus, such as the one of the SD card.
+
+#include "SpiDma.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <mbed.h>
+#include <rtos.h>
+
+#include <PeripheralPins.h>
+#include <hal/spi_api.h>
+#include <pinmap.h>
+
+#include "Dma.hpp"
+
+using namespace AjK; // for MODDMA.
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Transfers shorter than this are left to the CPU, as setting up the
+/// channels and sleeping costs more than polling a few bytes. Sector payloads
+/// are 512 bytes.
+constexpr int kMinDmaLength = 64;
+
+/// \brief Largest transfer of a single GPDMA channel setup.
+constexpr int kMaxDmaLength = 0xFFF;
+
+/// \brief RXDMAE | TXDMAE in the SSP DMA control register.
+constexpr std::uint32_t kSspDmaOn = 0x3;
+
+/// \brief RNE in the SSP status register.
+constexpr std::uint32_t kSspRxNotEmpty = 1u << 2;
+
+/// \brief The SSP of the attached bus, or null.
+LPC_SSP_TypeDef* attached_ssp = nullptr;
+
+/// \brief Whether transfers on the attached bus go by DMA.
+volatile bool enabled = true;
+
+/// \brief Released when the transfer in flight ends. Owned here rather than a
+/// thread flag, as the calling thread, such as the reader of the music player,
+/// has flags of its own.
+rtos::Semaphore transfer_done(0, 1);
+
+/// \brief Whether the transfer in flight failed.
+volatile bool transfer_failed;
+
+/// \brief Byte sent when there is nothing to send, and where received bytes go
+/// when they are not wanted. A channel does not step through either.
+char fill_byte;
+char sink_byte;
+
+/// \brief Channel setups, which the controller keeps pointers to.
+MODDMA_Config rx_conf;
+MODDMA_Config tx_conf;
+
+/// \brief Wake the waiting thread once the last byte is in.
+void
+rxDone_()
+{
+  transfer_done.release();
+}
+
+/// \brief Wake the waiting thread on a bus error of either channel.
+void
+dmaError_()
+{
+  transfer_failed = true;
+  transfer_done.release();
+}
+
+/// \brief Move one block of up to kMaxDmaLength bytes by DMA, and sleep until
+/// it is done.
+///
+/// \param tx Bytes to send, or null to send fill_byte.
+/// \param rx Where to receive, or null to drop what comes in.
+void
+transferBlock_(LPC_SSP_TypeDef* ssp, const char* tx, char* rx, int length)
+{
+  MODDMA&    dma = rb::dma();
+  const bool ssp1 = ssp == LPC_SSP1;
+
+  rx_conf.channelNum(rb::kDmaSdRx)
+    ->dstMemAddr(reinterpret_cast<std::uint32_t>(rx ? rx : &sink_byte))
+    ->transferSize(length)
+    ->transferType(MODDMA::p2m)
+    ->srcConn(ssp1 ? MODDMA::SSP1_Rx : MODDMA::SSP0_Rx)
+    ->attach_tc(&rxDone_)
+    ->attach_err(&dmaError_);
+  tx_conf.channelNum(rb::kDmaSdTx)
+    ->srcMemAddr(reinterpret_cast<std::uint32_t>(tx ? tx : &fill_byte))
+    ->transferSize(length)
+    ->transferType(MODDMA::m2p)
+    ->dstConn(ssp1 ? MODDMA::SSP1_Tx : MODDMA::SSP0_Tx)
+    ->attach_err(&dmaError_);
+  if (!dma.Setup(&rx_conf) || !dma.Setup(&tx_conf))
+    error("[SpiDma] Error in DMA Setup()!");
+
+  // Setup() steps through memory, which a single byte must not be.
+  if (!rx)
+    reinterpret_cast<LPC_GPDMACH_TypeDef*>(dma.Channel_p(rb::kDmaSdRx))
+      ->DMACCControl &= ~dma.CxControl_DI();
+  if (!tx)
+    reinterpret_cast<LPC_GPDMACH_TypeDef*>(dma.Channel_p(rb::kDmaSdTx))
+      ->DMACCControl &= ~dma.CxControl_SI();
+
+  // Anything left over from polled transfers would be taken as received.
+  while (ssp->SR & kSspRxNotEmpty)
+    (void)ssp->DR;
+
+  transfer_failed = false;
+  dma.Enable(&rx_conf);
+  dma.Enable(&tx_conf);
+  ssp->DMACR = kSspDmaOn;
+  transfer_done.acquire();
+
+  // The last byte in means the last one went out, but the transmit channel
+  // may not have shut down yet, and must not lose its requests while it has
+  // not. After an error, either channel may still be running.
+  if (transfer_failed) {
+    dma.Disable(rb::kDmaSdRx);
+    dma.Disable(rb::kDmaSdTx);
+  }
+  while (dma.Enabled(rb::kDmaSdTx) || dma.Enabled(rb::kDmaSdRx))
+    continue;
+  ssp->DMACR = 0;
+
+  if (transfer_failed)
+    error("[SpiDma] Error in DMA transfer!");
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+void
+spiDmaAttach(PinName sclk)
+{
+  attached_ssp = reinterpret_cast<LPC_SSP_TypeDef*>(
+    pinmap_peripheral(sclk, PinMap_SPI_SCLK));
+}
+
+void
+spiDmaEnable(bool enable)
+{
+  enabled = enable;
+}
+
+} // namespace rb
+
+extern "C" int
+__real_spi_master_block_write(
+  spi_t*      obj,
+  const char* tx_buffer,
+  int         tx_length,
+  char*       rx_buffer,
+  int         rx_length,
+  char        write_fill);
+
+/// \brief Stands in for the HAL block transfer, through the --wrap option of
+/// the linker.
+extern "C" int
+__wrap_spi_master_block_write(
+  spi_t*      obj,
+  const char* tx_buffer,
+  int         tx_length,
+  char*       rx_buffer,
+  int         rx_length,
+  char        write_fill)
+{
+  // Only one-sided or fully overlapping transfers, which are all SDBlockDevice
+  // makes, map onto a pair of channels.
+  const int total = std::max(tx_length, rx_length);
+  if (
+    !enabled || obj->spi != attached_ssp || total < kMinDmaLength ||
+    (tx_length != 0 && tx_length != total) ||
+    (rx_length != 0 && rx_length != total) || core_util_is_isr_active()) {
+    return __real_spi_master_block_write(
+      obj, tx_buffer, tx_length, rx_buffer, rx_length, write_fill);
+  }
+
+  const char* tx = tx_length ? tx_buffer : nullptr;
+  char*       rx = rx_length ? rx_buffer : nullptr;
+  fill_byte      = write_fill;
+  for (int done = 0; done < total;) {
+    const int length = std::min(total - done, kMaxDmaLength);
+    transferBlock_(
+      obj->spi, tx ? tx + done : nullptr, rx ? rx + done : nullptr, length);
+    done += length;
+  }
+  return total;
+}
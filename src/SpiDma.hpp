@@ -0,0 +1,43 @@
+/// \file SpiDma.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief DMA block transfers for an SPI bus, such as the one of the SD card.
+///
+/// \details mbed moves SPI blocks a byte at a time, with the CPU polling the
+/// SSP, and SDBlockDevice has no other way to move its sector payloads. The
+/// link wraps the HAL block transfer (see CMakeLists.txt), and long transfers
+/// on the attached bus are moved by two GPDMA channels instead, while the
+/// calling thread sleeps and leaves the CPU to the rest of the system.
+
+#ifndef RB_SPI_DMA_HPP
+#define RB_SPI_DMA_HPP
+
+#ifndef __cplusplus
+#error "SpiDma.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <PinNames.h>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Move the long transfers of an SPI bus by DMA.
+///
+/// Only one bus can be attached, on the channels given in Dma.hpp. Transfers
+/// must come from threads, which holds for SDBlockDevice.
+///
+/// \param sclk Clock pin of the bus, which tells its SSP.
+void
+spiDmaAttach(PinName sclk);
+
+/// \brief Turn DMA transfers on the attached bus on or off. On by default.
+void
+spiDmaEnable(bool enable);
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_SPI_DMA_HPP
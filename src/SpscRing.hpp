@@ -0,0 +1,164 @@
+/// \file SpscRing.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Lock-free single-producer single-consumer ring buffer.
+
+#ifndef RB_SPSC_RING_HPP
+#define RB_SPSC_RING_HPP
+
+#ifndef __cplusplus
+#error "SpscRing.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief Lock-free ring buffer for exactly one producer and one consumer.
+///
+/// The storage is provided by the user so it can be placed in a specific memory
+/// section (e.g. AHB SRAM). Only the read and write indices are shared between
+/// the two sides, each written by one side only, so no locking is needed. The
+/// indices run freely and are masked on access, which requires a power of two
+/// capacity but leaves all of it usable.
+///
+/// Besides copying in and out, both sides can access the storage in place
+/// through contiguous spans, e.g. to fread() straight into the ring.
+template<typename T>
+class SpscRing
+{
+ public:
+  /// \brief Constructor.
+  ///
+  /// \param storage Backing storage of at least capacity elements.
+  /// \param capacity Capacity of the ring. Must be a power of two.
+  SpscRing(T* storage, std::size_t capacity) :
+      _buf(storage),
+      _mask(capacity - 1),
+      _head(0),
+      _tail(0)
+  {
+  }
+
+  /// \brief Capacity of the ring.
+  std::size_t capacity() const { return _mask + 1; }
+
+  /// \brief Number of elements that can be read. Exact on the consumer side, a
+  /// lower bound on the producer side.
+  std::size_t size() const
+  {
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+  }
+
+  /// \brief Number of elements that can be written. Exact on the producer side,
+  /// a lower bound on the consumer side.
+  std::size_t space() const { return capacity() - size(); }
+
+  /// \brief Empty the ring. Only safe while neither side is using it.
+  void reset()
+  {
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+  }
+
+  // --------------------------- Producer side ---------------------------
+
+  /// \brief Get the largest contiguous writable region.
+  ///
+  /// \param span Set to the start of the region.
+  ///
+  /// \return The number of elements that can be written at span.
+  std::size_t writeSpan(T*& span)
+  {
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    const std::size_t tail = _tail.load(std::memory_order_acquire);
+    const std::size_t off  = head & _mask;
+    span                   = _buf + off;
+    return std::min(capacity() - (head - tail), capacity() - off);
+  }
+
+  /// \brief Publish elements written through writeSpan().
+  void commit(std::size_t count)
+  {
+    _head.store(
+      _head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+  /// \brief Copy elements into the ring.
+  ///
+  /// \return The number of elements written, limited by the free space.
+  std::size_t write(const T* data, std::size_t count)
+  {
+    std::size_t done = 0;
+    while (done < count) {
+      T*                span;
+      const std::size_t n = std::min(writeSpan(span), count - done);
+      if (n == 0)
+        break;
+      std::copy(data + done, data + done + n, span);
+      commit(n);
+      done += n;
+    }
+    return done;
+  }
+
+  // --------------------------- Consumer side ---------------------------
+
+  /// \brief Get the largest contiguous readable region.
+  ///
+  /// \param span Set to the start of the region.
+  ///
+  /// \return The number of elements that can be read at span.
+  std::size_t readSpan(const T*& span)
+  {
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+    const std::size_t head = _head.load(std::memory_order_acquire);
+    const std::size_t off  = tail & _mask;
+    span                   = _buf + off;
+    return std::min(head - tail, capacity() - off);
+  }
+
+  /// \brief Release elements read through readSpan().
+  void consume(std::size_t count)
+  {
+    _tail.store(
+      _tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+  /// \brief Copy elements out of the ring.
+  ///
+  /// \return The number of elements read, limited by the available data.
+  std::size_t read(T* data, std::size_t count)
+  {
+    std::size_t done = 0;
+    while (done < count) {
+      const T*          span;
+      const std::size_t n = std::min(readSpan(span), count - done);
+      if (n == 0)
+        break;
+      std::copy(span, span + n, data + done);
+      consume(n);
+      done += n;
+    }
+    return done;
+  }
+
+ private:
+  T* const          _buf;
+  const std::size_t _mask;
+
+  std::atomic<std::size_t> _head; // Written by the producer only.
+  std::atomic<std::size_t> _tail; // Written by the consumer only.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_SPSC_RING_HPP
@@ -0,0 +1,97 @@
+/// \file ToneSynth.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Direct digital synthesis of tones for the MusicPlayer.
+
+#include "ToneSynth.hpp"
+
+#include <algorithm>
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Phase step per sample of a frequency, with a full turn being 2^32.
+std::int64_t
+phaseStep_(int hz, int rate)
+{
+  return (static_cast<std::int64_t>(hz) << 32) / rate;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+namespace rb {
+
+void
+ToneSynth::start(const Tone& tone, int rate)
+{
+  _left = static_cast<long>(tone.duration_ms) * rate / 1000;
+  if (_left <= 0) {
+    _left = 0;
+    return;
+  }
+
+  const std::int64_t from = phaseStep_(tone.start_hz, rate);
+  const std::int64_t to   = phaseStep_(tone.end_hz, rate);
+  _inc                    = static_cast<std::uint32_t>(from);
+  _sweep                  = static_cast<std::int32_t>((to - from) / _left);
+
+  // A rest is silent, rather than holding whatever phase the last tone ended
+  // on.
+  const bool         rest  = tone.start_hz == 0 && tone.end_hz == 0;
+  const int          level = rest ? 0 : std::min(std::max(tone.level, 0), 256);
+  const std::int32_t peak  = level << 8;
+
+  const long attack =
+    std::min(static_cast<long>(tone.attack_ms) * rate / 1000, _left);
+  const long release =
+    std::min(static_cast<long>(tone.release_ms) * rate / 1000, _left - attack);
+  _attack_end   = _left - attack;
+  _release_from = release;
+  _attack_step  = attack > 0 ? peak / attack : 0;
+  _release_step = release > 0 ? (peak + release - 1) / release : 0;
+  _env          = attack > 0 ? 0 : peak;
+}
+
+// clang-format off
+const std::int16_t ToneSynth::kSine[257] = {
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+    6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+   27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+   32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+   27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+   18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+  -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+  -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+  -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+  -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804,
+       0
+};
+// clang-format on
+
+} // namespace rb
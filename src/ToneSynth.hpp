@@ -0,0 +1,104 @@
+/// \file ToneSynth.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Direct digital synthesis of tones for the MusicPlayer.
+///
+/// \details Plain C++ with no dependency on mbed or the hardware, like
+/// AudioFormat.hpp.
+
+#ifndef RB_TONE_SYNTH_HPP
+#define RB_TONE_SYNTH_HPP
+
+#ifndef __cplusplus
+#error "ToneSynth.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+
+#include "AudioFormat.hpp"
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+
+/// \brief One tone of a pattern.
+struct Tone
+{
+  int start_hz;    // Frequency at the start. 0 on both ends is a rest.
+  int end_hz;      // Frequency at the end, swept linearly.
+  int duration_ms;
+  int attack_ms;   // Linear fade in.
+  int release_ms;  // Linear fade out.
+  int level;       // Peak amplitude in 1/256ths of full scale.
+};
+
+/// \brief Sine synthesizer: a phase accumulator stepping through a wavetable,
+/// with a linear frequency sweep and envelope per tone.
+///
+/// The phase carries over from tone to tone, so back to back tones join
+/// without a click.
+class ToneSynth
+{
+ public:
+  /// \brief Start a tone, dropping what is left of the previous one.
+  ///
+  /// \param rate Samples per second to synthesize at.
+  void start(const Tone& tone, int rate);
+
+  /// \brief Synthesize the current tone into a buffer of DAC samples.
+  ///
+  /// \return The number of samples written, short of count only once the tone
+  /// is over.
+  template<typename Sample>
+  int render(Sample* buffer, int count);
+
+ private:
+  /// \brief One period of a sine, plus the first sample again so that
+  /// interpolation never wraps.
+  static const std::int16_t kSine[257];
+
+  std::uint32_t _phase        = 0;
+  std::uint32_t _inc          = 0; // Phase step per sample.
+  std::int32_t  _sweep        = 0; // Change of the phase step per sample.
+  std::int32_t  _env          = 0; // Amplitude, Q16.
+  std::int32_t  _attack_step  = 0;
+  std::int32_t  _release_step = 0;
+  long          _attack_end   = 0; // Samples left when the attack ends.
+  long          _release_from = 0; // Samples left when the release starts.
+  long          _left         = 0; // Samples of the tone left.
+};
+
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+
+template<typename Sample>
+int
+ToneSynth::render(Sample* buffer, int count)
+{
+  int out = 0;
+  for (; out < count && _left > 0; ++out, --_left) {
+    if (_left > _attack_end)
+      _env += _attack_step;
+    else if (_left <= _release_from)
+      _env = _env > _release_step ? _env - _release_step : 0;
+
+    // Interpolate between table entries on the top 16 bits of the phase.
+    const int i    = _phase >> 24;
+    const int frac = (_phase >> 8) & 0xFFFF;
+    const int s    = kSine[i] + (((kSine[i + 1] - kSine[i]) * frac) >> 16);
+
+    // The envelope never exceeds 1.0, so the product fits in 32 bits.
+    buffer[out] = dacSample((s * _env) >> 16);
+    _phase += _inc;
+    _inc += _sweep;
+  }
+  return out;
+}
+
+} // namespace rb
+
+#endif // RB_TONE_SYNTH_HPP
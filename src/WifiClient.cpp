@@ -8,10 +8,13 @@
 
 // #include "Endpoint.h"
 #include <algorithm>
+#include <cstring>
 #include <string>
 
 #include <mbed.h>
 
+#include "NodeMcuReply.hpp"
+
 // Debug is disabled by default
 // NOTE - MOST OF THESE FUNCTIONS DON'T WORK. WILL UPDATE LATER
 #if 0
@@ -41,6 +44,79 @@
 
 namespace {
 
+/// \brief Longest to wait for the prompt after a command that returns at once.
+constexpr auto kCommandTimeout = 1s;
+
+/// \brief Longest to wait for an HTTP response.
+constexpr auto kResponseTimeout = 10s;
+
+/// \brief How often to poll for a change of the connection.
+constexpr auto kPollInterval = 250ms;
+
+/// \brief Line printed by callbacks once they are done printing.
+constexpr char kEndMarker[] = "--rb-end--";
+
+/// \brief Line the module is asked to print back by probe().
+constexpr char kProbeMarker[] = "--rb-probe--";
+
+/// \brief Rates to try for the link, fastest first.
+///
+/// The link has no flow control, so whatever the module sends while no thread
+/// drains the port has to fit in the receive buffer of BufferedSerial. It is
+/// raised to 2 KiB in mbed_app.json (drivers.uart-serial-rxbuf-size), which
+/// holds 89 ms at 230400 baud, against 11 ms with the default of 256 bytes.
+constexpr int kBaudRates[] = {230400, 115200};
+static_assert(
+  MBED_CONF_DRIVERS_UART_SERIAL_RXBUF_SIZE >= 2048,
+  "Receive buffer too small for the fastest rate");
+
+/// \brief Command that moves the module to another rate, keeping the echo on.
+constexpr char kUartSetup[] =
+  "uart.setup(0,%d,8,uart.PARITY_NONE,uart.STOPBITS_1,1)\r\n";
+
+/// \brief Time for the module to act on a change of rate.
+constexpr auto kBaudSettle = 20ms;
+
+/// \brief Read the rate kept by saveBaud_().
+///
+/// \return The rate, or 0 if none is kept or it is not one of kBaudRates.
+int
+loadBaud_(const char* path)
+{
+  FILE* file = path ? fopen(path, "r") : nullptr;
+  if (!file)
+    return 0;
+  int baud = 0;
+  if (fscanf(file, "%d", &baud) != 1)
+    baud = 0;
+  fclose(file);
+  for (int rate : kBaudRates)
+    if (rate == baud)
+      return baud;
+  return 0;
+}
+
+/// \brief Keep a rate for later boots.
+void
+saveBaud_(const char* path, int baud)
+{
+  FILE* file = path ? fopen(path, "w") : nullptr;
+  if (!file)
+    return;
+  fprintf(file, "%d\n", baud);
+  fclose(file);
+}
+
+/// \brief Copy the first tab-separated field of a line.
+void
+copyField_(char* dst, int size, const char* src)
+{
+  int n = 0;
+  for (; n < size - 1 && src[n] && src[n] != '\t'; ++n)
+    dst[n] = src[n];
+  dst[n] = '\0';
+}
+
 } // namespace
 
 // ====================== Global Definitions =========================
@@ -56,12 +132,16 @@ WifiClient::WifiClient(
   int                       baud,
   std::chrono::microseconds timeout) :
     _serial(tx, rx),
-    _reset_pin(reset)
+    _reset_pin(reset),
+    _rx(_rx_buf, kRxRingSize)
 {
   INFO("Initializing WifiClient");
 
-  _baud    = baud;
-  _timeout = timeout;
+  _baud         = baud;
+  _link_baud    = baud;
+  _timeout      = timeout;
+  _socket       = false;
+  _http_host[0] = '\0';
 
   _serial.set_baud(_baud);
 
@@ -69,6 +149,9 @@ WifiClient::WifiClient(
   FILE* serialstream = fdopen(&_serial, "w");
   _handle.file       = serialstream;
 
+  // Threads waiting on the module sleep until the port wakes them.
+  _serial.sigio(callback(this, &WifiClient::onSigio));
+
   _inst = this;
 }
 
@@ -80,18 +163,65 @@ WifiClient::reset()
     wait_us(20);
     _reset_pin = 1;
   } else {
-    // Send reboot command in case reset is not connected
-    printCMD(&_handle, 1s, "node.restart()\r\n");
-    flushBuffer();
+    // Send reboot command in case reset is not connected. The REPL gives the
+    // prompt back before the module goes down.
+    command(nullptr, 0, kCommandTimeout, "node.restart()\r\n");
   }
-  return true;
+
+  // The module boots at its default rate, whatever the link was at, and with
+  // none of the state of its Lua REPL.
+  _serial.set_baud(_baud);
+  _link_baud    = _baud;
+  _socket       = false;
+  _http_host[0] = '\0';
+
+  // The module prints its banner once it is back up, and then the prompt.
+  Reply boot(nullptr, 0, Reply::LineStart);
+  return await(boot, _timeout);
 }
 
 bool
-WifiClient::init()
+WifiClient::init(const char* baud_file)
 {
+  // Without the reset pin, the module is reset through the link. If only this
+  // side restarted, the link may still be at the kept rate.
+  const int saved = loadBaud_(baud_file);
+  if (saved && !_reset_pin.is_connected()) {
+    _serial.set_baud(saved);
+    _link_baud = saved;
+    if (!probe()) {
+      _serial.set_baud(_baud);
+      _link_baud = _baud;
+    }
+  }
+
   // Reset device to clear state
-  return reset();
+  if (!reset())
+    return false;
+
+  // A rate that worked before is taken as is. A rate that fails leaves the
+  // module at the rate it was at, or restarted at its default one, unless it
+  // stopped answering altogether.
+  if (saved) {
+    if (setBaud(saved))
+      return true;
+    remove(baud_file);
+    if (!probe())
+      return false;
+  }
+
+  for (int rate : kBaudRates) {
+    if (rate <= _baud || rate == saved)
+      continue;
+    if (setBaud(rate)) {
+      saveBaud_(baud_file, rate);
+      return true;
+    }
+    if (!probe())
+      return false;
+  }
+  INFO("Staying at %d baud", _baud);
+  return true;
 }
 
 bool
@@ -113,72 +243,67 @@ bool
 WifiClient::connect(const char* ssid, const char* phrase)
 {
   // Configure as station with passed ssid and passphrase
-  printCMD(&_handle, 1s, "wifi.setmode(wifi.STATION)\r\n");
-  ThisThread::sleep_for(500ms);
-  printCMD(&_handle, 1s, "wifi.sta.config(\"%s\",\"%s\")\r\n", ssid, phrase);
-  flushBuffer();
+  command(nullptr, 0, kCommandTimeout, "wifi.setmode(wifi.STATION)\r\n");
+  command(
+    nullptr,
+    0,
+    kCommandTimeout,
+    "wifi.sta.config(\"%s\",\"%s\")\r\n",
+    ssid,
+    phrase);
 
   Timer timer;
   timer.start();
-  // keep checking for valid ip
-  flushBuffer();
+  // keep checking for valid ip, which getip() prints along with the netmask
+  // and gateway
+  char reply[64];
   while (timer.elapsed_time() < _timeout) {
-    printCMD(&_handle, 1s, "print(wifi.sta.getip())\r\n");
-    getreply(_ip, 16);
+    if (command(
+          reply, sizeof(reply), kCommandTimeout, "print(wifi.sta.getip())\r\n"))
+      copyField_(_ip, sizeof(_ip), reply);
     // printf("%s\n", _ip); //DEBUG ONLY
-    if (strcmp(_ip, "nil") != 0) {
-      timer.stop();
-      timer.reset();
+    if (strcmp(_ip, "nil") != 0)
       return 1;
-    }
+    ThisThread::sleep_for(kPollInterval);
   }
-  timer.stop();
-  timer.reset();
   return 0;
 }
 
 bool
 WifiClient::disconnect()
 {
-  printCMD(&_handle, 1s, "wifi.sta.disconnect()\r\n");
-  flushBuffer();
+  command(nullptr, 0, kCommandTimeout, "wifi.sta.disconnect()\r\n");
   Timer timer;
   timer.start();
   // make sure that wifi station has ip nil
+  char reply[64];
   while (timer.elapsed_time() < _timeout) {
-    memset(_ip, '\0', sizeof(_ip));
-    printCMD(&_handle, 1s, "print(wifi.sta.getip())\r\n");
-    getreply(_ip, 3);
+    if (command(
+          reply, sizeof(reply), kCommandTimeout, "print(wifi.sta.getip())\r\n"))
+      copyField_(_ip, sizeof(_ip), reply);
     // printf("%s\n", _ip); //DEBUG ONLY
-    if (strcmp(_ip, "nil") == 0) {
-      timer.stop();
-      timer.reset();
+    if (strcmp(_ip, "nil") == 0)
       return 1;
-    }
+    ThisThread::sleep_for(kPollInterval);
   }
-  printCMD(&_handle, 1s, "print(wifi.sta.getip())\r\n");
-  getreply(_ip, 16);
-  timer.stop();
-  timer.reset();
   return 0;
 }
 
 int
 WifiClient::scan(char* aplist, int size)
 {
-  printCMD(&_handle, 1s, "function listap(t)\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "for k,v in pairs(t) do\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "print(k)\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "end\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "end\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "wifi.sta.getap(listap)\r\n");
-  getreply(aplist, size);
-  return 1;
+  // The list comes from a callback, which marks where it ends.
+  static_assert(
+    sizeof(kEndMarker) - 1 <= Reply::kMaxMarker, "End marker too long");
+  if (!command(
+        nullptr,
+        0,
+        kCommandTimeout,
+        "wifi.sta.getap(function(t) for k in pairs(t) do print(k) end "
+        "print(\"%s\") end)\r\n",
+        kEndMarker))
+    return 0;
+  return getreply_marked(kEndMarker, aplist, size, _timeout);
 }
 
 int
@@ -189,22 +314,79 @@ WifiClient::http_get_request(
   char*       respBuffer,
   size_t      respBufferSize)
 {
-  printCMD(&_handle, 1s, "sk=net.createConnection(net.TCP, 0)\r\n");
-  flushBuffer();
-  printCMD(
-    &_handle, 1s, "sk:on(\"receive\", function(sck, c) print(c) end )\r\n");
-  flushBuffer();
-  printCMD(&_handle, 1s, "sk:connect(80,\"%s\")\r\n", address);
-  flushBuffer();
-  printCMD(
-    &_handle,
-    1s,
-    "sk:send(\"GET %s HTTP/1.1\\r\\nHost: %s\\r\\n%s\\r\\n\\r\\n\")\r\n",
+  if (std::strcmp(_http_host, address) != 0 && !openSocket(address))
+    return 0;
+
+  // The request waits in skw until some of the response is in. It goes out
+  // at once on an open connection, and from the connection handler otherwise.
+  command(
+    nullptr,
+    0,
+    kCommandTimeout,
+    "skq=\"GET %s HTTP/1.1\\r\\nHost: %s\\r\\nConnection: "
+    "keep-alive\\r\\n%s\\r\\n\\r\\n\"\r\n",
     payload,
     address,
     header);
-  getreply_json(respBuffer, respBufferSize);
-  return 1;
+  command(
+    nullptr,
+    0,
+    kCommandTimeout,
+    "skw=skq skr=1 if skup then sk:send(skq) else sk:connect(80,skh) end\r\n");
+  if (getreply_json(respBuffer, respBufferSize, kResponseTimeout))
+    return 1;
+
+  // Start over with a new socket on the next request.
+  _http_host[0] = '\0';
+  return 0;
+}
+
+bool
+WifiClient::openSocket(const char* address)
+{
+  // Whatever socket there is goes, even one to the same address that failed,
+  // or to one too long to remember.
+  if (_socket)
+    command(nullptr, 0, kCommandTimeout, "sk:close() sk=nil\r\n");
+  _socket       = false;
+  _http_host[0] = '\0';
+
+  // The handlers stay with the socket for as long as it is kept. A server that
+  // closes the connection with a request outstanding gets it again on a new
+  // connection, once. A line may run even if its prompt is lost, so the socket
+  // is taken to exist from the first one on.
+  _socket = true;
+  const bool ok =
+    command(
+      nullptr,
+      0,
+      kCommandTimeout,
+      "sk=net.createConnection(net.TCP, 0) skup=false skh=\"%s\"\r\n",
+      address) &&
+    command(
+      nullptr,
+      0,
+      kCommandTimeout,
+      "sk:on(\"receive\", function(s, c) skw=nil print(c) end)\r\n") &&
+    command(
+      nullptr,
+      0,
+      kCommandTimeout,
+      "sk:on(\"connection\", function(s) skup=true "
+      "if skw then s:send(skw) end end)\r\n") &&
+    command(
+      nullptr,
+      0,
+      kCommandTimeout,
+      "sk:on(\"disconnection\", function(s) skup=false "
+      "if skw and skr>0 then skr=skr-1 s:connect(80,skh) end end)\r\n");
+  if (!ok)
+    return false;
+
+  const int length = snprintf(_http_host, sizeof(_http_host), "%s", address);
+  if (length < 0 || length >= static_cast<int>(sizeof(_http_host)))
+    _http_host[0] = '\0'; // Too long to remember, so made again each time.
+  return true;
 }
 
 int
@@ -216,117 +398,185 @@ WifiClient::printCMD(
 {
   va_list args;
   va_start(args, fmt);
+  const int sent = vprintCMD(handle, timeout, fmt, args);
+  va_end(args);
+  return sent;
+}
+
+int
+WifiClient::vprintCMD(
+  Handle*                   handle,
+  std::chrono::microseconds timeout,
+  const char*               fmt,
+  va_list                   args)
+{
   Timer t;
   t.start();
-  while (t.elapsed_time() < timeout) {
-    if (handle->serial->writable()) {
-      vfprintf(handle->file, fmt, args);
-      va_end(args);
-      return 1;
-    }
-  }
-  va_end(args);
-  return 0;
+  while (!handle->serial->writable())
+    if (!waitSerial(t, timeout))
+      return 0;
+  vfprintf(handle->file, fmt, args);
+  fflush(handle->file);
+  return 1;
 }
 
 bool
-WifiClient::discardEcho()
+WifiClient::command(
+  char*                     resp,
+  int                       size,
+  std::chrono::microseconds timeout,
+  const char*               fmt,
+  ...)
 {
-  char c;
-  int  num;
-  while (true) {
-    num = _serial.read(&c, 1);
-    // pc.write(&c, num); //debug
-    if (num < 0)
-      return false;
-    else if (c == '>' || c == '\r') {
-      _serial.read(&c, 1);
-      return true;
-    }
-  }
+  // Drop anything left over from earlier, such as output of callbacks, which
+  // would be taken for the echo.
+  do {
+    _rx.consume(_rx.size());
+    drainSerial();
+  } while (_rx.size() > 0);
+
+  va_list args;
+  va_start(args, fmt);
+  const int sent = vprintCMD(&_handle, timeout, fmt, args);
+  va_end(args);
+  if (!sent)
+    return false;
+
+  Reply reply(resp, size, Reply::Echo);
+  return await(reply, timeout);
 }
 
-void
-WifiClient::flushBuffer(int len)
+bool
+WifiClient::await(Reply& reply, std::chrono::microseconds timeout)
 {
   Timer t;
   t.start();
-  int  n = 0;
-  char c;
-  while (t.elapsed_time() < 1s && n != len) {
-    if (_serial.readable()) {
-      _serial.read(&c, 1);
-      n++;
-      // pc.write(&c, 1); //DEBUG ONLY
+  while (true) {
+    drainSerial();
+    const char*       span;
+    const std::size_t n = _rx.readSpan(span);
+    if (n == 0) {
+      if (!waitSerial(t, timeout))
+        return false;
+      continue;
     }
+    _rx.consume(reply.feed(span, n));
+    if (reply.state == Reply::Done)
+      return true;
   }
 }
 
-// todo: clean up
-int
-WifiClient::getreply(char* resp, int size)
+bool
+WifiClient::probe()
 {
-  if (!discardEcho()) {
+  char reply[sizeof(kProbeMarker) + 8];
+  return command(
+           reply,
+           sizeof(reply),
+           kCommandTimeout,
+           "print(\"%s\")\r\n",
+           kProbeMarker) &&
+         std::strcmp(reply, kProbeMarker) == 0;
+}
+
+bool
+WifiClient::setBaud(int baud)
+{
+  // The module switches as soon as it runs the line, so this end follows once
+  // the line is out, at 10 bits a byte, and the module has acted on it.
+  auto request = [this](int to) {
+    char      line[sizeof(kUartSetup) + 8];
+    const int length = snprintf(line, sizeof(line), kUartSetup, to);
+    if (!printCMD(&_handle, kCommandTimeout, "%s", line))
+      return false;
+    ThisThread::sleep_for(
+      std::chrono::milliseconds(length * 10 * 1000 / _link_baud + 1) +
+      kBaudSettle);
+    _serial.set_baud(to);
+    _link_baud = to;
+    return true;
+  };
+
+  const int from = _link_baud;
+  if (!request(baud))
     return false;
+  if (probe())
+    return true;
+
+  // Ask the module to go back, in case the link works one way.
+  request(from);
+  if (probe())
+    return false;
+
+  // Failing that, this end cannot tell which rate the module is at. It comes
+  // back from a restart at its default rate, so without the reset pin the
+  // restart is sent at both rates.
+  if (!_reset_pin.is_connected()) {
+    _serial.set_baud(baud);
+    _link_baud = baud;
+    command(nullptr, 0, kCommandTimeout, "node.restart()\r\n");
+    _serial.set_baud(from);
+    _link_baud = from;
   }
-  Timer t;
-  t.start();
-  char c;
-  int  cnt = 0;
-  while (t.elapsed_time() < 3s) {
-    if (_serial.readable()) {
-      _serial.read(&c, 1);
-      // special case to filter
-      if (c == '>') {
-        flushBuffer(2);
-        continue;
-      }
-
-      if (resp) {
-        strncat(resp, &c, 1);
-        cnt++;
-      }
-      if (cnt == size)
-        break;
-      // pc.write(&c, num); //DEBUG ONLY
-    }
-  }
-  flushBuffer();
-  return 1;
+  reset();
+  return false;
 }
 
-int
-WifiClient::getreply_json(char* resp, int size)
+bool
+WifiClient::waitSerial(const Timer& timer, std::chrono::microseconds timeout)
 {
-  if (!discardEcho()) {
+  const auto elapsed = timer.elapsed_time();
+  if (elapsed >= timeout)
     return false;
+
+  // A change since the port was last checked leaves the flag set, so this
+  // returns at once rather than missing it. Waking without one just costs a
+  // recheck.
+  const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+    timeout - elapsed);
+  _serial_events.wait_any_for(
+    kSerialEvent, rtos::Kernel::Clock::duration_u32(left.count()));
+  return true;
+}
+
+void
+WifiClient::onSigio()
+{
+  _serial_events.set(kSerialEvent);
+}
+
+void
+WifiClient::drainSerial()
+{
+  char*       span;
+  std::size_t n;
+  while (_serial.readable() && (n = _rx.writeSpan(span)) > 0) {
+    const ssize_t got = _serial.read(span, n);
+    if (got <= 0)
+      break;
+    _rx.commit(got);
   }
-  Timer t;
-  t.start();
-  char c;
-  int  cnt          = 0;
-  int  fwd_brackets = 0;
-  while (t.elapsed_time() < 10s) {
-    if (_serial.readable()) {
-      _serial.read(&c, 1);
-      // special case to filter
-      if (c == '{') {
-        fwd_brackets++;
-      } else if (c == '}') {
-        fwd_brackets--;
-      }
-
-      if (resp && fwd_brackets > 0) {
-        strncat(resp, &c, 1);
-        cnt++;
-      }
-      if (cnt == size)
-        break;
-      // pc.write(&c, num); //DEBUG ONLY
-    }
-  }
-  flushBuffer();
-  return 1;
+}
+
+bool
+WifiClient::getreply_marked(
+  const char*               marker,
+  char*                     resp,
+  int                       size,
+  std::chrono::microseconds timeout)
+{
+  Reply reply(resp, size, Reply::LineStart, marker);
+  return await(reply, timeout);
+}
+
+bool
+WifiClient::getreply_json(
+  char*                     resp,
+  int                       size,
+  std::chrono::microseconds timeout)
+{
+  Reply reply(resp, size, Reply::LineStart, nullptr, true);
+  return await(reply, timeout);
 }
 
 } // namespace rb
@@ -14,11 +14,16 @@
 #endif // __cplusplus
 
 #include <mbed.h>
+#include <rtos.h>
+
+#include "SpscRing.hpp"
 
 // ======================= Public Interface ==========================
 
 namespace rb {
 
+struct NodeMcuReply;
+
 class WifiClient
 {
   struct Handle
@@ -42,10 +47,17 @@ class WifiClient
     int                       baud    = 9600,
     std::chrono::microseconds timeout = 5s);
 
-  /// \brief Initialize the wifi hardware
+  /// \brief Initialize the wifi hardware, and move the link to the fastest
+  /// rate it carries.
   ///
-  /// \return true if successful
-  bool init();
+  /// The rate found is kept in baud_file, so later boots go straight to it
+  /// instead of trying each rate. The link stays at the rate given to the
+  /// constructor if no faster one works.
+  ///
+  /// \param baud_file optional file to keep the link rate in
+  ///
+  /// \return true if successful, false if the module does not answer
+  bool init(const char* baud_file = nullptr);
 
   /// \brief Connect the wifi module to the specified ssid.
   ///
@@ -76,6 +88,9 @@ class WifiClient
   int scan(char* aplist, int size);
 
   /// \brief Send a request.
+  ///
+  /// The connection to the server is kept open between requests to the same
+  /// address, and opened again when the server closes it.
   int http_get_request(
     const char* address,
     const char* payload,
@@ -83,17 +98,19 @@ class WifiClient
     char*       respBuffer,
     size_t      respBufferSize);
 
-  /// \brief Reset the wifi module
+  /// \brief Reset the wifi module, which brings the link back to the rate
+  /// given to the constructor.
   bool reset();
 
+  /// \brief Get the current rate of the link.
+  int baud() const { return _link_baud; }
+
   /// \brief Obtains the current instance of the ESP8266
   static WifiClient* getInstance() { return _inst; };
 
  private:
-  /// \brief Discards echoed characters
-  ///
-  /// \return true if successful
-  bool discardEcho();
+  /// \brief Tracks the reply to a command on the NodeMCU REPL.
+  using Reply = NodeMcuReply;
 
   /// \brief Sends formatted string over serial port
   ///
@@ -109,16 +126,90 @@ class WifiClient
     const char*               fmt,
     ...);
 
-  /// \brief Flushes BufferedSerial Buffer
-  void flushBuffer(int len = -1);
+  /// \brief printCMD() with a va_list.
+  int vprintCMD(
+    Handle*                   handle,
+    std::chrono::microseconds timeout,
+    const char*               fmt,
+    va_list                   args);
 
-  /// \brief Gets reply from ESP8662
-  /// \param resp optional buffer to store response
-  /// \return 1 if successful
-  int getreply(char* resp = 0, int size = 0);
+  /// \brief Run a line on the REPL, and collect what it prints.
+  ///
+  /// Returns as soon as the prompt comes back, so the timeout only bounds how
+  /// long a command that never finishes can hold things up.
+  ///
+  /// \param resp optional buffer for the output, without the echo and prompt
+  /// \param size size of resp, including the terminator
+  /// \param timeout longest to wait for the prompt
+  /// \param fmt line to send, formatted as by printCMD()
+  ///
+  /// \return true if the prompt came back
+  bool command(
+    char*                     resp,
+    int                       size,
+    std::chrono::microseconds timeout,
+    const char*               fmt,
+    ...);
 
-  /// \brief Get reply from ESP8266 in json format.
-  int getreply_json(char* resp, int size);
+  /// \brief Feed bytes from the module to a reply until it is complete.
+  ///
+  /// Whatever follows the reply stays in the receive ring for the next one.
+  ///
+  /// \return true if it completed before the timeout
+  bool await(Reply& reply, std::chrono::microseconds timeout);
+
+  /// \brief Move what the serial port has received into the receive ring, in
+  /// as few reads as the free space allows.
+  void drainSerial();
+
+  /// \brief Set up the socket of the module for requests to an address,
+  /// closing the one to the previous address.
+  ///
+  /// \return true if successful
+  bool openSocket(const char* address);
+
+  /// \brief Check that the module answers at the current rate.
+  ///
+  /// \return true if it echoed a marker back
+  bool probe();
+
+  /// \brief Move both ends of the link to another rate.
+  ///
+  /// \return true if the module answers at the new rate. Otherwise the link is
+  /// taken back to the rate it was at, or if the module does not answer there
+  /// either, it is restarted, and the link is at its default rate.
+  bool setBaud(int baud);
+
+  /// \brief Sleep until the serial port changes state, or the time is up.
+  ///
+  /// \param timer timer started at the beginning of the operation
+  /// \param timeout time allowed for the whole operation
+  ///
+  /// \return false if the time is up
+  bool waitSerial(const Timer& timer, std::chrono::microseconds timeout);
+
+  /// \brief Called by the serial port, from an interrupt, when it can be read
+  /// or written.
+  void onSigio();
+
+  /// \brief Collect the output lines printed by a callback, up to a line
+  /// consisting of marker, which is dropped.
+  ///
+  /// \return true if the marker came before the timeout
+  bool getreply_marked(
+    const char*               marker,
+    char*                     resp,
+    int                       size,
+    std::chrono::microseconds timeout);
+
+  /// \brief Collect the first JSON object printed by a callback. Returns as
+  /// soon as its braces balance.
+  ///
+  /// \return true if the object completed before the timeout
+  bool getreply_json(
+    char*                     resp,
+    int                       size,
+    std::chrono::microseconds timeout);
 
  protected:
   mbed::BufferedSerial _serial;
@@ -126,12 +217,26 @@ class WifiClient
 
   Handle _handle;
 
+  /// \brief Size of the receive ring. Must be a power of two.
+  static constexpr std::size_t kRxRingSize = 512;
+
+  char           _rx_buf[kRxRingSize];
+  SpscRing<char> _rx; // Received from the module, not yet parsed.
+
+  /// \brief Set on _serial_events by onSigio().
+  static constexpr std::uint32_t kSerialEvent = 1;
+
+  rtos::EventFlags _serial_events;
+
   static WifiClient* _inst;
 
   // TODO WISHLIST: ipv6?
   // this requires nodemcu support
   char                      _ip[16];
-  int                       _baud;
+  int                       _baud;      // Rate the module boots at.
+  int                       _link_baud; // Rate the link is at.
+  bool                      _socket;    // Whether the module may hold sk.
+  char                      _http_host[64]; // Address sk is set up for.
   std::chrono::microseconds _timeout;
 };
 
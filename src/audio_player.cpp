@@ -12,6 +12,7 @@
 #include <array>
 
 #include <mbed.h>
+#include <rtos.h>
 
 #include "MusicPlayer.h"
 #include "weather_data.hpp"
@@ -20,19 +21,98 @@
 
 namespace {
 
-// plays audio file from file passed in
+// clips queued up to be played back to back
+// names are kept here since the player reads them while it plays
+struct Playlist
+{
+  static constexpr int kMaxClips = 24;
+
+  std::array<std::array<char, 64>, kMaxClips> names;
+  std::array<const char*, kMaxClips>          ptrs;
+  int                                         count = 0;
+};
+
+Playlist playlist;
+
+// job playing the playlist in the background
+MusicPlayerJob playlist_job = {};
+
+// job playing the alarm, kept apart from the playlist so it can cut in
+MusicPlayerJob alarm_job = {};
+
+// the alarm is synthesized, so it sounds even without the card
+// three short beeps and a rising sweep, played twice
+const MusicPlayerTone alarm_tones[] = {
+  // start_hz, end_hz, duration_ms, attack_ms, release_ms, level
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {660, 1320, 400, 10, 60, 224},
+  {0, 0, 300, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {660, 1320, 400, 10, 60, 224},
+};
+
+// set once the playlist or alarm job is done
+rtos::EventFlags playlist_flags;
+
+// checks if a job is still with the player
+bool
+job_busy(const MusicPlayerJob& job)
+{
+  return job.state == MusicPlayerJob_Queued ||
+         job.state == MusicPlayerJob_Playing;
+}
+
+// waits until the player is done with the playlist, so it can be refilled
+void
+wait_playlist()
+{
+  while (job_busy(playlist_job))
+    playlist_flags.wait_any(0x1);
+}
+
+// queues audio file from file passed in
 // param filename the filename past the root to plat
 void
-play_file(const char* filename)
+queue_file(const char* filename)
 {
-  std::array<char, 64> fname = {0};
-  auto needed = snprintf(fname.data(), fname.size(), SFX_DIR "%s", filename);
+  if (playlist.count >= Playlist::kMaxClips) {
+    MBED_ERROR(
+      MBED_MAKE_ERROR(MBED_MODULE_APPLICATION, MBED_ERROR_CODE_ENOMEM),
+      "Too many queued files");
+  }
+  auto& fname  = playlist.names[playlist.count];
+  auto  needed = snprintf(fname.data(), fname.size(), SFX_DIR "%s", filename);
   if (needed >= fname.size()) {
     MBED_ERROR(
       MBED_MAKE_ERROR(MBED_MODULE_APPLICATION, MBED_ERROR_CODE_ENOMEM),
       "Filename too long");
   }
-  playMusic(fname.data(), 1.0);
+  playlist.ptrs[playlist.count++] = fname.data();
+}
+
+// starts playing all the queued files without gaps between them
+// returns once the files are handed to the player
+void
+play_queued()
+{
+  playlist_job.file_names = playlist.ptrs.data();
+  playlist_job.count      = playlist.count;
+  playlist_job.speed      = 1.0;
+  playlist_job.priority   = MusicPlayerPriority_Announcement;
+  playlist_job.done       = [](MusicPlayerJob*) { playlist_flags.set(0x1); };
+  while (playSequenceAsync(&playlist_job))
+    ThisThread::sleep_for(10ms);
+  playlist.count = 0;
 }
 
 // reads a numbner 10-19
@@ -42,34 +122,34 @@ play_teens(int number)
 {
   switch (number) {
     case 10:
-      play_file("numbers/ten.pcm");
+      queue_file("numbers/ten.pcm");
       break;
     case 11:
-      play_file("numbers/eleven.pcm");
+      queue_file("numbers/eleven.pcm");
       break;
     case 12:
-      play_file("numbers/twelve.pcm");
+      queue_file("numbers/twelve.pcm");
       break;
     case 13:
-      play_file("numbers/thirteen.pcm");
+      queue_file("numbers/thirteen.pcm");
       break;
     case 14:
-      play_file("numbers/fourteen.pcm");
+      queue_file("numbers/fourteen.pcm");
       break;
     case 15:
-      play_file("numbers/fifteen.pcm");
+      queue_file("numbers/fifteen.pcm");
       break;
     case 16:
-      play_file("numbers/sixteen.pcm");
+      queue_file("numbers/sixteen.pcm");
       break;
     case 17:
-      play_file("numbers/seventeen.pcm");
+      queue_file("numbers/seventeen.pcm");
       break;
     case 18:
-      play_file("numbers/eighteen.pcm");
+      queue_file("numbers/eighteen.pcm");
       break;
     case 19:
-      play_file("numbers/nineteen.pcm");
+      queue_file("numbers/nineteen.pcm");
       break;
     // if not a teen, move on
     default:
@@ -83,7 +163,7 @@ read_number(int number)
 {
   // check for negative
   if (number < 0) {
-    play_file("numbers/negative.pcm");
+    queue_file("numbers/negative.pcm");
     // make positive
     number = number * -1;
   }
@@ -97,36 +177,36 @@ read_number(int number)
       // dont read ones place
       return;
     case 2:
-      play_file("numbers/twenty.pcm");
+      queue_file("numbers/twenty.pcm");
       break;
     case 3:
-      play_file("numbers/thirty.pcm");
+      queue_file("numbers/thirty.pcm");
       break;
     case 4:
-      play_file("numbers/forty.pcm");
+      queue_file("numbers/forty.pcm");
       break;
     case 5:
-      play_file("numbers/fifty.pcm");
+      queue_file("numbers/fifty.pcm");
       break;
     case 6:
-      play_file("numbers/sixty.pcm");
+      queue_file("numbers/sixty.pcm");
       break;
     case 7:
-      play_file("numbers/seventy.pcm");
+      queue_file("numbers/seventy.pcm");
       break;
     case 8:
-      play_file("numbers/eighty.pcm");
+      queue_file("numbers/eighty.pcm");
       break;
     case 9:
-      play_file("numbers/ninety.pcm");
+      queue_file("numbers/ninety.pcm");
       break;
     case 10:
-      play_file("numbers/hundred.pcm");
+      queue_file("numbers/hundred.pcm");
       // one hundred
       break;
     case 11:
       // one hundred and tens
-      play_file("numbers/hundred.pcm");
+      queue_file("numbers/hundred.pcm");
       play_teens(number - 100);
       // dont play ones place
       return;
@@ -137,36 +217,36 @@ read_number(int number)
   // read ones place after
   switch (ones) {
     case 1:
-      play_file("numbers/one.pcm");
+      queue_file("numbers/one.pcm");
       break;
     case 2:
-      play_file("numbers/two.pcm");
+      queue_file("numbers/two.pcm");
       break;
     case 3:
-      play_file("numbers/three.pcm");
+      queue_file("numbers/three.pcm");
       break;
     case 4:
-      play_file("numbers/four.pcm");
+      queue_file("numbers/four.pcm");
       break;
     case 5:
-      play_file("numbers/five.pcm");
+      queue_file("numbers/five.pcm");
       break;
     case 6:
-      play_file("numbers/six.pcm");
+      queue_file("numbers/six.pcm");
       break;
     case 7:
-      play_file("numbers/seven.pcm");
+      queue_file("numbers/seven.pcm");
       break;
     case 8:
-      play_file("numbers/eight.pcm");
+      queue_file("numbers/eight.pcm");
       break;
     case 9:
-      play_file("numbers/nine.pcm");
+      queue_file("numbers/nine.pcm");
       break;
     default:
       // read 0 iff exactly 0, avoids "nintey zero"
       if (tens == 0)
-        play_file("numbers/zero.pcm");
+        queue_file("numbers/zero.pcm");
       break;
   }
 }
@@ -179,7 +259,19 @@ read_number(int number)
 void
 play_alarm()
 {
-  play_file("alarm.pcm");
+  // an alarm already going is left to finish
+  if (job_busy(alarm_job))
+    return;
+  alarm_job.tones      = alarm_tones;
+  alarm_job.count      = sizeof(alarm_tones) / sizeof(alarm_tones[0]);
+  alarm_job.speed      = 1.0;
+  alarm_job.priority   = MusicPlayerPriority_Alarm;
+  // wake up gradually rather than with a jolt
+  alarm_job.fade_in_ms = 2000;
+  alarm_job.fade_curve = MusicPlayerFade_Exponential;
+  alarm_job.done       = [](MusicPlayerJob*) { playlist_flags.set(0x1); };
+  while (playSequenceAsync(&alarm_job))
+    ThisThread::sleep_for(10ms);
 }
 
 // reads all weather data
@@ -187,68 +279,57 @@ play_alarm()
 void
 play_audio(weather_data* data)
 {
+  wait_playlist();
+
   // read temperature
-  play_file("temperature/itis.pcm");
+  queue_file("temperature/itis.pcm");
   read_number(data->temperature);
-  play_file("temperature/doutside.pcm");
+  queue_file("temperature/doutside.pcm");
 
   // read precipitation chance
-  play_file("precipitation/there_is.pcm");
+  queue_file("precipitation/there_is.pcm");
   read_number(data->precipitation_chance);
-  play_file("precipitation/percent_chance.pcm");
+  queue_file("precipitation/percent_chance.pcm");
 
   // read wind speed
-  play_file("wind/wind_speed.pcm");
+  queue_file("wind/wind_speed.pcm");
   read_number(data->wind_speed);
-  play_file("wind/mph.pcm");
+  queue_file("wind/mph.pcm");
 
   // read humidity
-  play_file("humidity/humidity.pcm");
+  queue_file("humidity/humidity.pcm");
   read_number(data->humidity);
-  play_file("humidity/percent.pcm");
+  queue_file("humidity/percent.pcm");
 
   // read weather
-  // only one allowed, if any condition is satified, return
+  // only one allowed, the first condition satisfied wins
   // if no sutable phrase, say nothing
-  if (strstr(data->weather.c_str(), "thunder")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/thunderstorms.pcm");
-    return;
-  }
+  const char* weather = data->weather.c_str();
+  const char* phrase  = nullptr;
+  if (strstr(weather, "thunder"))
+    phrase = "weather/thunderstorms.pcm";
+  else if (strstr(weather, "rain") || strstr(weather, "drizzle"))
+    phrase = "weather/raining.pcm";
+  else if (strstr(weather, "snow") || strstr(weather, "sleet"))
+    phrase = "weather/snowing.pcm";
+  else if (strstr(weather, "partly"))
+    phrase = "weather/partly_cloudy.pcm";
+  else if (strstr(weather, "cloud") || strstr(weather, "over"))
+    phrase = "weather/cloudy.pcm";
+  else if (strstr(weather, "sun"))
+    phrase = "weather/sunny.pcm";
 
-  if (
-    strstr(data->weather.c_str(), "rain") ||
-    strstr(data->weather.c_str(), "drizzle")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/raining.pcm");
-    return;
-  }
-
-  if (
-    strstr(data->weather.c_str(), "snow") ||
-    strstr(data->weather.c_str(), "sleet")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/snowing.pcm");
-    return;
+  if (phrase) {
+    queue_file("weather/weather.pcm");
+    queue_file(phrase);
   }
 
-  if (strstr(data->weather.c_str(), "partly")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/partly_cloudy.pcm");
-    return;
-  }
-
-  if (
-    strstr(data->weather.c_str(), "cloud") ||
-    strstr(data->weather.c_str(), "over")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/cloudy.pcm");
-    return;
-  }
+  // play the whole report in one go
+  play_queued();
+}
 
-  if (strstr(data->weather.c_str(), "sun")) {
-    play_file("weather/weather.pcm");
-    play_file("weather/sunny.pcm");
-    return;
-  }
+bool
+audio_busy()
+{
+  return job_busy(playlist_job) || job_busy(alarm_job);
 }
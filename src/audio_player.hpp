@@ -13,14 +13,27 @@
 
 /// \brief reads the weather data on the speaker
 ///
+/// Returns as soon as the report is handed to the player. If a previous report
+/// is still playing, waits for it to finish first.
+///
 /// \param data The weather data to print.
 void
 play_audio(weather_data* data);
 
 /// \brief plays the alarm sound
+///
+/// Returns as soon as the alarm is handed to the player. Does not wait for a
+/// report that is playing, but cuts in over it and ducks it. Does nothing if
+/// the alarm is already going.
 void
 play_alarm();
 
+/// \brief checks if a report or alarm is still playing
+///
+/// \return true if the speaker is busy
+bool
+audio_busy();
+
 // ===================== Detail Implementation =======================
 
 #endif // AUDIO_PLAYER_HPP
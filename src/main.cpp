@@ -13,12 +13,14 @@
 #include <mbed.h>
 #include <mbed_error.h>
 
-#include <FATFileSystem.h>
 #include <SDBlockDevice.h>
 #include <hal/spi_api.h>
 
+#include "CachedBlockDevice.hpp"
+#include "FatVolume.hpp"
 #include "LCD_Control.hpp"
 #include "MusicPlayer.h"
+#include "SpiDma.hpp"
 #include "audio_player.hpp"
 #include "pinout.hpp"
 #include "weather_data.hpp"
@@ -54,7 +56,10 @@ const char* header = "Accept: application/xml";
 int
 startWifi()
 {
-  wifi.init();
+  if (!wifi.init(WIFI_BAUD_FILE)) {
+    printf("The wifi module does not answer!\n");
+    return 0;
+  }
   // char ap_list[256];
   // wifi.scan(ap_list, 256);
   wifi.connect(ssid, pwd);
@@ -120,29 +125,59 @@ updateweather(weather_data* data)
   return 1;
 }
 
+#if SD_DMA_BENCHMARK
+/// \brief Spins counted by the background thread of benchmarkSd().
+volatile unsigned int benchmark_spins;
+volatile bool         benchmark_running;
+
+void
+countSpins()
+{
+  while (benchmark_running)
+    benchmark_spins = benchmark_spins + 1;
+}
+
+/// \brief Read the card with polled and with DMA SPI transfers, and print the
+/// throughput of each, along with how far a background thread got meanwhile.
+/// The background thread only runs while the reader sleeps, so its count is
+/// the CPU time the transfers left to the rest of the system.
+void
+benchmarkSd(BlockDevice& bd)
+{
+  constexpr int         kReads = 64;
+  static std::uint8_t   buffer[8 * 512];
+  rtos::Thread          spinner(osPriorityLow, 512);
+  benchmark_running = true;
+  spinner.start(countSpins);
+
+  for (bool dma : {false, true}) {
+    rb::spiDmaEnable(dma);
+    benchmark_spins = 0;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < kReads; ++i)
+      bd.read(buffer, i * sizeof(buffer), sizeof(buffer));
+    timer.stop();
+    const long long us = timer.elapsed_time().count();
+    debug(
+      "\r\n[main] SD %s: %lld KiB/s, %u background spins.",
+      dma ? "DMA" : "polled",
+      kReads * static_cast<long long>(sizeof(buffer)) * 1000000 / 1024 / us,
+      benchmark_spins);
+  }
+
+  benchmark_running = false;
+  spinner.join();
+  rb::spiDmaEnable(true);
+}
+#endif // SD_DMA_BENCHMARK
+
 } // namespace
 
 // ====================== Global Definitions =========================
 int
 main()
 {
-  // wifi
-  printf("Starting demo...\n");
-  startWifi();
-  printf("Connected! Beginning HTTP get...\n");
-  weather_data  data_;
-  weather_data* data = &data_;
-  updateweather(data);
-
-  debug("\r\n\t[main] Weather Data: {");
-  debug("\r\n\tHumidity: %d%", data->humidity);
-  debug("\r\n\tPrecipitation Chance: %d%", data->precipitation_chance);
-  debug("\r\n\tTemperature: %d degrees F", data->temperature);
-  debug("\r\n\tWind Speed: %d mph", data->wind_speed);
-  debug("\r\n\tWeather Description: %s", data->weather.c_str());
-  debug("\r\n\tFinished.");
-  debug("\r\n}");
-
   debug("\r\n[main] Starting up.");
 
   debug("\r\n[main] Seeding rand...");
@@ -161,11 +196,16 @@ main()
     debug(" maxumum speed: %d...", caps.maximum_frequency);
     sd.frequency(caps.maximum_frequency);
   }
+  rb::spiDmaAttach(rb::pinout::kSD_sck);
   debug(" done.");
 
+  // Static, as the cache buffers would not fit on the main stack.
+  static rb::CachedBlockDevice card(&sd);
+
   debug("\r\n[main] Mounting SD card...");
-  FATFileSystem fs(AUX_MOUNT_POINT, &sd);
+  rb::FatVolume fs(AUX_MOUNT_POINT, &card);
   debug(" done.");
+  musicPlayerUseBlockDevice(&fs, &card);
 
   debug("\r\n[main] Opening root file directory...");
   if (printdir()) {
@@ -174,12 +214,44 @@ main()
       "Could not open root file directory.");
   }
   debug(" done.");
+#if SD_DMA_BENCHMARK
+  benchmarkSd(sd);
+#endif // SD_DMA_BENCHMARK
+  {
+    const rb::CachedBlockDevice::Stats stats = card.stats();
+    debug(
+      "\r\n[main] Card cache: %u hits, %u misses, %u reads.",
+      stats.hits,
+      stats.misses,
+      stats.device_reads);
+  }
+
+  // wifi, after the card is mounted, as the link rate to the module is kept on
+  // it.
+  printf("Starting demo...\n");
+  startWifi();
+  printf("Connected! Beginning HTTP get...\n");
+  weather_data  data_;
+  weather_data* data = &data_;
+  updateweather(data);
+
+  debug("\r\n\t[main] Weather Data: {");
+  debug("\r\n\tHumidity: %d%", data->humidity);
+  debug("\r\n\tPrecipitation Chance: %d%", data->precipitation_chance);
+  debug("\r\n\tTemperature: %d degrees F", data->temperature);
+  debug("\r\n\tWind Speed: %d mph", data->wind_speed);
+  debug("\r\n\tWeather Description: %s", data->weather.c_str());
+  debug("\r\n\tFinished.");
+  debug("\r\n}");
 
   debug("\r\n[main] Running weather demo...");
   while (true) {
     Display_Weather(data);
     ThisThread::sleep_for(1s);
-    play_audio(data);
+    // plays in the background, the loop is free while the report is read. A
+    // report or alarm still going is left to finish rather than waited on.
+    if (!audio_busy())
+      play_audio(data);
     ThisThread::sleep_for(10s);
   }
 }
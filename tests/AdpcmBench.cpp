@@ -0,0 +1,139 @@
+/// \file AdpcmBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of IMA ADPCM decoding into DAC samples, against the PCM
+/// conversions it competes with.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "AdpcmVector.hpp"
+#include "AudioFormat.hpp"
+#include "Bench.hpp"
+#include "Check.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Samples decoded per run.
+constexpr int kSamples = 1 << 20;
+
+/// \brief Runs of each variant. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief Samples per decoded chunk, kVoiceChunk of the MusicPlayer.
+constexpr int kChunk = 32;
+
+/// \brief Decode blocks of ADPCM, a chunk at a time, the way the voices do.
+///
+/// \return The sum of the samples.
+std::uint32_t
+decodeAdpcm_(const std::vector<std::uint8_t>& coded, std::uint16_t* out)
+{
+  rb::ImaAdpcm  decoder;
+  std::uint32_t sum = 0;
+  for (std::size_t at = 0; at < coded.size(); at += kAdpcmBlock) {
+    const std::uint8_t* block = coded.data() + at;
+    sum += decoder.header(block);
+    int n = 0;
+    for (int i = rb::ImaAdpcm::kHeaderSize; i < kAdpcmBlock; ++i) {
+      out[n++] = decoder.nibble(block[i] & 0xF);
+      out[n++] = decoder.nibble(block[i] >> 4);
+      if (n == kChunk) {
+        for (int j = 0; j < n; ++j)
+          sum += out[j];
+        n = 0;
+      }
+    }
+    for (int j = 0; j < n; ++j)
+      sum += out[j];
+  }
+  return sum;
+}
+
+/// \brief Convert PCM frames in place, a chunk at a time.
+template<int Bits>
+std::uint32_t
+convert_(const std::vector<std::uint8_t>& raw, std::uint16_t* out)
+{
+  constexpr int kFrame = Bits / 8;
+  std::uint32_t sum    = 0;
+  for (std::size_t at = 0; at + kChunk * kFrame <= raw.size();
+       at += kChunk * kFrame) {
+    // The frames are read into the buffer the samples are written to.
+    std::copy(
+      raw.data() + at,
+      raw.data() + at + kChunk * kFrame,
+      reinterpret_cast<std::uint8_t*>(out));
+    rb::convertPcm<Bits, 1>(out, kChunk);
+    sum += out[0] + out[kChunk - 1];
+  }
+  return sum;
+}
+
+/// \brief Time a variant over kRuns runs.
+///
+/// \param samples Number of samples of each run.
+///
+/// \return The fewest timestamp cycles per sample of any run.
+template<typename F>
+double
+time_(long samples, F&& run)
+{
+  double best = 1e30;
+  for (int i = 0; i < kRuns; ++i) {
+    const std::uint64_t start = rb::test::cycles();
+    rb::test::keep(run());
+    best = std::min<double>(best, rb::test::cycles() - start);
+  }
+  return best / samples;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  constexpr int kPerBlock = 1 + 2 * (kAdpcmBlock - rb::ImaAdpcm::kHeaderSize);
+
+  // The test vector over and over, which is a fair mix of step sizes.
+  std::vector<std::uint8_t> coded;
+  while (coded.size() / kAdpcmBlock * kPerBlock < kSamples)
+    coded.insert(coded.end(), kAdpcmCoded, kAdpcmCoded + sizeof(kAdpcmCoded));
+  const long blocks = coded.size() / kAdpcmBlock;
+
+  std::vector<std::uint8_t>  raw(2 * kSamples, 0x5A);
+  std::vector<std::uint16_t> out(kChunk);
+
+  // Decoding has to be right before it is worth timing.
+  std::uint32_t expect = 0;
+  for (std::int16_t sample : kAdpcmDecoded)
+    expect += rb::dacSample(sample);
+  RB_CHECK_EQ(
+    decodeAdpcm_(coded, out.data()),
+    static_cast<std::uint32_t>(expect * (blocks / 2)));
+
+  const double adpcm = time_(blocks * kPerBlock, [&] {
+    return decodeAdpcm_(coded, out.data());
+  });
+  const double u8 =
+    time_(2 * kSamples, [&] { return convert_<8>(raw, out.data()); });
+  const double s16 =
+    time_(kSamples, [&] { return convert_<16>(raw, out.data()); });
+
+  std::printf("%-12s %14s %14s\n", "", "cycles/sample", "bits/sample");
+  std::printf(
+    "%-12s %14.2f %14.2f\n",
+    "IMA ADPCM",
+    adpcm,
+    8.0 * kAdpcmBlock / kPerBlock);
+  std::printf("%-12s %14.2f %14d\n", "8-bit PCM", u8, 8);
+  std::printf("%-12s %14.2f %14d\n", "16-bit PCM", s16, 16);
+  return rb::test::result();
+}
@@ -0,0 +1,125 @@
+/// \file AdpcmTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of the IMA ADPCM decoder and WAV parsing: bit-exactness
+/// against the reference codec, through the block layout the MusicPlayer
+/// reads.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "AdpcmVector.hpp"
+#include "AudioFormat.hpp"
+#include "Check.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Decode the test vector block by block, each block starting on its
+/// header and going on low nibble first, and compare every sample with the
+/// reference at full resolution and as a DAC sample.
+void
+testBitExact_()
+{
+  rb::ImaAdpcm decoder;
+  int          out        = 0;
+  int          mismatches = 0;
+  auto         expect     = [&](std::uint16_t dac) {
+    const int ref = kAdpcmDecoded[out++];
+    if (decoder.predictor() != ref || dac != rb::dacSample(ref))
+      ++mismatches;
+  };
+
+  for (int block = 0; block < 2; ++block) {
+    const std::uint8_t* data = kAdpcmCoded + block * kAdpcmBlock;
+    expect(decoder.header(data));
+    for (int i = rb::ImaAdpcm::kHeaderSize; i < kAdpcmBlock; ++i) {
+      expect(decoder.nibble(data[i] & 0xF));
+      expect(decoder.nibble(data[i] >> 4));
+    }
+  }
+  RB_CHECK_EQ(out, sizeof(kAdpcmDecoded) / sizeof(kAdpcmDecoded[0]));
+  RB_CHECK_EQ(mismatches, 0);
+}
+
+/// \brief Append a little-endian integer to a buffer.
+void
+putLE_(std::uint8_t*& p, std::uint32_t value, int bytes)
+{
+  for (int i = 0; i < bytes; ++i)
+    *p++ = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+/// \brief Parse a WAV file holding the test vector, with an extra chunk ahead
+/// of the data, and check that it lands on the first block.
+void
+testParseWav_()
+{
+  std::uint8_t  file[128 + sizeof(kAdpcmCoded)] = {};
+  std::uint8_t* p                                = file;
+  std::memcpy(p, "RIFF", 4);
+  p += 4;
+  std::uint8_t* riff_size = p;
+  p += 4;
+  std::memcpy(p, "WAVEfmt ", 8);
+  p += 8;
+  putLE_(p, 20, 4);                        // fmt chunk size.
+  putLE_(p, 0x11, 2);                      // IMA ADPCM.
+  putLE_(p, 1, 2);                         // Channels.
+  putLE_(p, 24000, 4);                     // Samples per second.
+  putLE_(p, 24000 * kAdpcmBlock / 249, 4); // Bytes per second.
+  putLE_(p, kAdpcmBlock, 2);               // Bytes per block.
+  putLE_(p, 4, 2);                         // Bits per sample.
+  putLE_(p, 2, 2);                         // Extra bytes.
+  putLE_(p, 249, 2);                       // Samples per block.
+  std::memcpy(p, "LIST", 4);
+  p += 4;
+  putLE_(p, 3, 4); // Odd sized, so padded to 4.
+  p += 4;
+  std::memcpy(p, "data", 4);
+  p += 4;
+  putLE_(p, sizeof(kAdpcmCoded), 4);
+  const long data_at = p - file;
+  std::memcpy(p, kAdpcmCoded, sizeof(kAdpcmCoded));
+  p += sizeof(kAdpcmCoded);
+  std::uint8_t* end = riff_size;
+  putLE_(end, p - file - 8, 4);
+
+  std::FILE* f = std::tmpfile();
+  if (!RB_CHECK(f))
+    return;
+  std::fwrite(file, 1, p - file, f);
+  std::rewind(f);
+
+  rb::WavFormat format = {};
+  RB_CHECK(rb::parseWav(f, p - file, format));
+  RB_CHECK_EQ(format.tag, rb::kWavImaAdpcm);
+  RB_CHECK_EQ(format.rate, 24000);
+  RB_CHECK_EQ(format.bits, 4);
+  RB_CHECK_EQ(format.channels, 1);
+  RB_CHECK_EQ(format.block, kAdpcmBlock);
+  RB_CHECK_EQ(format.size, sizeof(kAdpcmCoded));
+  RB_CHECK_EQ(std::ftell(f), data_at);
+
+  // Stereo ADPCM is not supported.
+  std::fseek(f, 22, SEEK_SET);
+  std::fputc(2, f);
+  std::rewind(f);
+  RB_CHECK(!rb::parseWav(f, p - file, format));
+  std::fclose(f);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  testBitExact_();
+  testParseWav_();
+  return rb::test::result();
+}
@@ -0,0 +1,108 @@
+/// \file AdpcmVector.hpp
+///
+/// \brief IMA ADPCM test vector, written by mkadpcmvector.py.
+
+#ifndef RB_TESTS_ADPCM_VECTOR_HPP
+#define RB_TESTS_ADPCM_VECTOR_HPP
+
+#include <cstdint>
+
+/// \brief Bytes per block.
+constexpr int kAdpcmBlock = 128;
+
+/// \brief Two blocks of mono IMA ADPCM, as in a WAV data chunk.
+// clang-format off
+const std::uint8_t kAdpcmCoded[256] = {
+  0x00, 0x00, 0x00, 0x00, 0x77, 0x77, 0x77, 0x77, 0x13, 0x10, 0x01, 0x80,
+  0x98, 0xba, 0xcd, 0xdb, 0xbb, 0xbc, 0xbb, 0x8a, 0x18, 0x63, 0x44, 0x34,
+  0x23, 0x13, 0x90, 0xdb, 0xbd, 0xbc, 0x9b, 0x08, 0x44, 0x34, 0x24, 0x81,
+  0xb9, 0xbe, 0xbb, 0x09, 0x52, 0x44, 0x12, 0x98, 0xbc, 0xbc, 0x08, 0x53,
+  0x43, 0x81, 0xda, 0xab, 0x1a, 0x53, 0x14, 0xa1, 0xdb, 0x9a, 0x40, 0x43,
+  0x91, 0xcb, 0xab, 0x42, 0x34, 0xa0, 0xbd, 0x1a, 0x53, 0x03, 0xcb, 0x8c,
+  0x31, 0x15, 0xb9, 0x9c, 0x40, 0x23, 0xca, 0xab, 0x62, 0x02, 0xca, 0x0a,
+  0x53, 0xa1, 0xbb, 0x48, 0x14, 0xd9, 0x1a, 0x33, 0xc1, 0x9c, 0x42, 0x92,
+  0xad, 0x31, 0x83, 0xcc, 0x30, 0x03, 0xcc, 0xf0, 0x08, 0x88, 0x47, 0x00,
+  0xf0, 0x0a, 0x88, 0x27, 0x00, 0xf0, 0x8a, 0x80, 0x27, 0x00, 0xf0, 0x8a,
+  0x80, 0x27, 0x00, 0xf0, 0x8a, 0x80, 0x27, 0x00, 0xff, 0x7f, 0x55, 0x00,
+  0x0d, 0x08, 0x08, 0x08, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x08, 0x88,
+  0x00, 0x88, 0x80, 0x00, 0x88, 0x00, 0x08, 0x88, 0x00, 0x88, 0x80, 0x00,
+  0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00, 0x88, 0x00,
+  0x88, 0x00, 0x08, 0x08, 0x08, 0x88, 0x80, 0x80, 0x90, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x77, 0x7f, 0xf7, 0xf7, 0x45, 0x0f, 0x83, 0x0d, 0x02, 0x1d,
+  0xb2, 0x21, 0x91, 0x0e, 0x01, 0x0a, 0xd2, 0xa2, 0x85, 0xa1, 0xc3, 0x4a,
+  0x08, 0xd2, 0xa1, 0xa1, 0x32, 0x5c, 0xc0, 0xc2, 0x31, 0x1a, 0x9b, 0x05,
+  0x1c, 0x19, 0xa0, 0x80, 0x87, 0xa0, 0x8a, 0x87, 0x80, 0x08, 0x8b, 0x94,
+  0x99, 0x01, 0x6a, 0x2b, 0x00, 0x6c, 0x0a, 0xa0, 0xa4, 0x38, 0xa0, 0x6a,
+  0xc8, 0x30, 0x99, 0xb2, 0x28, 0xd3, 0x83, 0xbb, 0x41, 0x8b, 0x94, 0xb5,
+  0x30, 0x99, 0x8b, 0xc5,
+};
+
+/// \brief The blocks as decoded by the reference codec.
+const std::int16_t kAdpcmDecoded[498] = {
+       0,     11,     41,    104,    240,    533,   1164,   2521,
+    5431,   8340,   9474,   9817,  10753,  11605,  11863,  12097,
+   11884,  11690,  11162,  10361,   9342,   7885,   6139,   4497,
+    2151,    -34,  -2022,  -4346,  -6531,  -8519, -10326, -11499,
+  -11712, -11906, -11378, -10257,  -8363,  -6039,  -3228,    174,
+    3376,   6285,   8175,  10579,  11515,  11799,  11025,   9383,
+    7037,   3602,    400,  -3342,  -6864, -10066, -11312, -11690,
+  -11347,  -8536,  -5134,  -1017,   2857,   7386,  10429,  12089,
+   11586,  10214,   7305,   2391,  -2296,  -6556, -10430, -11939,
+  -11482,  -9404,  -5246,   -265,   5762,   9814,  12023,  11354,
+    9529,   4548,   -139,  -5618, -10774, -11443, -10835,  -6961,
+   -1426,   3730,   9757,  12188,  11452,   8104,   1408,  -4832,
+   -8884, -12567, -10559,  -6299,   -211,   7083,  10024,  12698,
+    8646,   3490,  -3876,  -8778, -11452, -10642,  -4012,   2228,
+    9522,  12463,   9789,   4116,  -2514,  -8754, -12806,  -9123,
+   -3096,   4198,  11061,  11952,   7900,   -203,  -7753, -12655,
+   -9981,  -4308,   3795,  11345,  12325,   6085,  -1209, -10034,
+  -11220,  -7985,  -1122,   8684,  12599,   9040,   1490,  -7335,
+  -10894,  -9816,   -991,   7314,  12707,   7805,   -218,  -7768,
+  -12670,  -8213,   2323,   9501,  10806,   4874,  -4834, -11360,
+  -10174,  -2624,   8162,  12468,   5942,  -2363,  -9913, -10893,
+   -2870,   6838,  10753,   7194,  -4671, -12567,  -8261,    875,
+    9180,  12415,   3590,  -7089, -11395,  -4869,   5810,  12988,
+    9073,  -3979, -12665,  -7928,   2121,  11257,  10071,    363,
+  -11384,  -9805,    244,   9380,  10566,    858, -10889,  -9310,
+  -30846, -32768, -29970, -32513, -32768,  -1235,  32767,  32767,
+   32767,  32767, -13399, -32768, -29044, -32429, -32768,   9203,
+   29681,  32767,  32767,  32767,  -9204, -29682, -32768, -29383,
+  -32460,   9511,  29989,  32767,  32767,  32767,  -9204, -29682,
+  -32768, -29383, -32460,   9511,  29989,  32767,  32767,  32767,
+   -9204, -29682, -32768, -29383, -32460,   9511,  29989,  32767,
+   32767,  32767,  -1088,   3007,   -717,   2668,   -409,   2389,
+    -154,   2158,     56,  -1855,   -118,   1461,     26,  -1279,
+     -93,    985,      5,   -886,    -76,    660,     -9,    599,
+      46,   -457,      0,    415,     37,   -306,      6,   -278,
+     -20,    214,      1,   -193,    -17,    143,     -2,    130,
+      10,    -99,      0,     90,      8,    -66,      2,    -59,
+      -3,     48,      2,    -40,     -2,     32,      1,    -27,
+      -1,     22,      1,    -18,     -1,     15,      1,    -12,
+       0,     11,      1,     -8,      0,      7,      1,     -5,
+       0,      5,      1,     -3,      0,      3,      0,      2,
+       0,      2,      0,      2,      1,      0,      1,      0,
+       1,      0,      1,      0,      0,      0,      0,      0,
+       0,      0,      0,      0,      0,      0,     11,     41,
+     -22,    114,    407,   -224,   1133,  -1777,   2796,   8275,
+   -2775,  -1196,   8853,   7548,  -5504,  -3767,   4129,   5564,
+   -8793,  -3060,   5626,  -5428,  -1122,   5404,   8963,   5728,
+   -7019,  -5282,   -545,    890,  -5636,  -4450,    943,  -9843,
+   -2665,  -9191,   3861,   2124,   6861,   -317,   8819,  -1860,
+   -9038,   2709,   1130,   2565,   9091,  -3961,   1250,  -6646,
+   -2340,  -8866,  -2934,   4616,  -4209,   8843,  10580,  -3634,
+    5921,  -9715,  -3409,   9968,   1282,   6019,  -4030,  -7945,
+    5107,   6844,  -7370,  -1637,  -6848,  -2111,   -676,  -7202,
+   -6016,  -7094,   7614,   5512,   7423,  -1263,  -9159, -10594,
+    8984,   6186,   8729,   6417,   4315,   6226,  -5934,  -7513,
+    5409,    198,  -4539,  -8845,  -4930,  -3744,  -9137,   3610,
+   -8550,   -654,    781,   2086,  -8593,  10072,  -2646,   -334,
+    1768,  -7787,   7849,  -2662,  -4573,   7587,   9166,   1988,
+   -4538,  10887,   8785,  -8415,  -6103,   8612,   2879,  -2332,
+    5564,  -4485,  -5790,    142,   7692,  -3094,   6955,   5650,
+   -2655, -10205,  -7264,    759,  -6791,  -7771,    252,  -2983,
+    7803,  -2246,   -941,   7364,   4129,   1188,  -5052,  -5862,
+    2241,  -7467,
+};
+// clang-format on
+
+#endif // RB_TESTS_ADPCM_VECTOR_HPP
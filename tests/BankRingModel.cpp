@@ -0,0 +1,170 @@
+/// \file BankRingModel.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Model of the DAC bank ring of the MusicPlayer, against the two banks
+/// it replaced.
+///
+/// \details The DAC plays the banks back to back, and the refill thread is
+/// woken at the end of each bank, some time later, to mix every bank that is
+/// free. A bank that is not mixed by the time the DAC gets to it is an
+/// underrun. The wake-up time is drawn from a distribution with a long tail,
+/// for when the refill is held up by an interrupt or a higher priority thread.
+///
+/// With two banks, the interrupt stopped the channel and set up the next bank
+/// before the DAC could go on, so every bank ended on a gap, and a refill had
+/// a single bank of time. The LLI ring never stops, and a refill has all of
+/// the ring ahead of the DAC.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include "Check.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Sample rate, MUSIC_PLAYER_DEFAULT_PCM_RATE.
+constexpr double kRate = 24000;
+
+/// \brief Seconds of audio played per configuration.
+constexpr double kSeconds = 60;
+
+/// \brief CPU cycles per second.
+constexpr double kClock = 96e6;
+
+/// \brief CPU cycles to mix a sample, for a couple of voices.
+constexpr double kMixCycles = 150;
+
+/// \brief Seconds from a bank interrupt to the refill thread running.
+class WakeLatency_
+{
+ public:
+  explicit WakeLatency_(unsigned int seed) : _rng(seed) {}
+
+  double operator()()
+  {
+    // Scheduling takes a few microseconds, and now and then the thread waits
+    // out an interrupt or a higher priority thread for a few milliseconds.
+    double t = 5e-6 + _tail(_rng);
+    if (_stall(_rng) < kStallChance)
+      t += _spell(_rng);
+    return t;
+  }
+
+ private:
+  static constexpr double kStallChance = 0.005;
+
+  std::mt19937                           _rng;
+  std::exponential_distribution<double>  _tail{1 / 50e-6};
+  std::uniform_real_distribution<double> _stall{0, 1};
+  std::uniform_real_distribution<double> _spell{1e-3, 4e-3};
+};
+
+/// \brief Outcome of a run.
+struct Result_
+{
+  long   banks;
+  long   underruns; // Banks the DAC got to before they were mixed.
+  long   gaps;      // Bank boundaries where the DAC stopped.
+  double slack;     // Least time from a bank being mixed to it playing.
+};
+
+/// \brief Play kSeconds of audio through a ring.
+///
+/// \param count Number of banks.
+/// \param size Samples per bank.
+/// \param stop Seconds the DAC stops at the end of each bank, for the channel
+/// to be set up again. 0 for a ring that never stops.
+Result_
+run_(int count, int size, double stop, unsigned int seed)
+{
+  WakeLatency_ wake(seed);
+  const double period = size / kRate;
+  const double mix    = size * kMixCycles / kClock;
+  const long   banks  = static_cast<long>(kSeconds / period);
+
+  Result_ result = {banks, 0, 0, 1e9};
+  double  busy   = 0; // When the refill thread is done with the last refill.
+  long    mixed  = count; // Banks mixed, all of them before the DAC starts.
+  for (long done = 1; done <= banks; ++done) {
+    // Bank done - 1 has just played out, so bank done starts now.
+    const double end = done * (period + stop);
+    if (stop > 0)
+      ++result.gaps;
+
+    // The banks already played, up to done - 1, are free to mix over.
+    double t = std::max(busy, end + wake());
+    for (; mixed < done + count; ++mixed) {
+      const double start = mixed * (period + stop); // When bank mixed plays.
+      t += mix;
+      if (t > start) {
+        // Late: the DAC replays a stale bank, and the refill skips ahead to
+        // the bank after it, like the player does.
+        ++result.underruns;
+        continue;
+      }
+      result.slack = std::min(result.slack, start - t);
+    }
+    busy = t;
+  }
+  return result;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::printf(
+    "%.0f s at %.0f Hz, %.0f cycles/sample to mix at %.0f MHz\n",
+    kSeconds,
+    kRate,
+    kMixCycles,
+    kClock / 1e6);
+  std::printf(
+    "%-14s %6s %8s %10s %8s %10s\n",
+    "",
+    "bank",
+    "banks",
+    "underruns",
+    "gaps",
+    "slack ms");
+
+  // The two banks the interrupt set up the channel for, which takes it a
+  // couple of microseconds.
+  for (int size : {64, 128, 256, 512, 1024}) {
+    const Result_ r = run_(2, size, 2e-6, 1);
+    std::printf(
+      "%-14s %6d %8ld %10ld %8ld %10.2f\n",
+      "two banks",
+      size,
+      r.banks,
+      r.underruns,
+      r.gaps,
+      r.slack * 1e3);
+    if (size == 64)
+      RB_CHECK(r.underruns > 0); // The model does catch underruns.
+  }
+
+  // The ring of MUSIC_PLAYER_AUDIO_BUF_BANK_COUNT banks, down to
+  // MUSIC_PLAYER_MIN_BANK_SIZE.
+  for (int size : {64, 128, 256}) {
+    const Result_ r = run_(8, size, 0, 1);
+    std::printf(
+      "%-14s %6d %8ld %10ld %8ld %10.2f\n",
+      "8 bank ring",
+      size,
+      r.banks,
+      r.underruns,
+      r.gaps,
+      r.slack * 1e3);
+    RB_CHECK_EQ(r.underruns, 0);
+    RB_CHECK_EQ(r.gaps, 0);
+  }
+  return rb::test::result();
+}
@@ -0,0 +1,81 @@
+/// \file Bench.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Timing for the host benchmarks.
+
+#ifndef RB_TESTS_BENCH_HPP
+#define RB_TESTS_BENCH_HPP
+
+#ifndef __cplusplus
+#error "Bench.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+namespace test {
+
+/// \brief Get a monotonic time in seconds.
+double
+now();
+
+/// \brief Get the CPU timestamp counter, or nanoseconds on hosts without one.
+///
+/// The counter ticks at a fixed rate close to the nominal clock, so cycle
+/// figures are for comparing one variant with another, not for predicting the
+/// cycles of the board.
+std::uint64_t
+cycles();
+
+/// \brief Keep a value from being optimized away.
+template<typename T>
+void
+keep(const T& value);
+
+} // namespace test
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+namespace test {
+
+inline double
+now()
+{
+  return std::chrono::duration<double>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+inline std::uint64_t
+cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+#endif
+}
+
+template<typename T>
+inline void
+keep(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace test
+} // namespace rb
+
+#endif // RB_TESTS_BENCH_HPP
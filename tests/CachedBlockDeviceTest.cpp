@@ -0,0 +1,114 @@
+/// \file CachedBlockDeviceTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::CachedBlockDevice: what is served from the window and
+/// the sector cache, what goes straight to the device, and writes dropping
+/// cached copies.
+
+#include <cstdint>
+#include <vector>
+
+#include "CachedBlockDevice.hpp"
+#include "Check.hpp"
+#include "FileBlockDevice.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+constexpr std::uint32_t kSector = rb::CachedBlockDevice::kSectorSize;
+constexpr std::uint32_t kWindow = rb::CachedBlockDevice::kWindowSectors;
+
+/// \brief Sectors of the device.
+constexpr std::uint32_t kDeviceSectors = 64;
+
+/// \brief Byte at an offset of the device.
+std::uint8_t
+byteOf_(std::size_t offset)
+{
+  return static_cast<std::uint8_t>(offset * 13 + offset / 509);
+}
+
+/// \brief Read sectors through the cache, and check them against the device.
+void
+checkRead_(rb::CachedBlockDevice& cache, std::uint32_t sector, int count)
+{
+  std::vector<std::uint8_t> out(count * kSector);
+  if (!RB_CHECK_EQ(cache.read(out.data(), sector * kSector, out.size()), 0))
+    return;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    if (!RB_CHECK_EQ(out[i], byteOf_(sector * kSector + i)))
+      return;
+  }
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<std::uint8_t> data(kDeviceSectors * kSector);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = byteOf_(i);
+  rb::test::FileBlockDevice device(data.data(), data.size());
+  rb::CachedBlockDevice     cache(&device);
+  RB_CHECK_EQ(cache.init(), 0);
+
+  // A file read a sector at a time fills the window once, and is served from
+  // it after.
+  for (std::uint32_t s = 0; s < kWindow; ++s)
+    checkRead_(cache, s, 1);
+  rb::CachedBlockDevice::Stats stats = cache.stats();
+  RB_CHECK_EQ(device.stats().commands, 1);
+  RB_CHECK_EQ(stats.hits, kWindow - 1);
+  RB_CHECK_EQ(stats.read_ahead, kWindow - 1);
+
+  // Reads of several sectors go straight to the device, even when they follow
+  // on from the last, and nothing is copied out of the cache.
+  device.resetStats();
+  cache.resetStats();
+  for (std::uint32_t s = kWindow; s < 4 * kWindow; s += 2)
+    checkRead_(cache, s, 2);
+  stats = cache.stats();
+  RB_CHECK_EQ(device.stats().commands, 3 * kWindow / 2);
+  RB_CHECK_EQ(stats.hits, 0u);
+  RB_CHECK_EQ(stats.read_ahead, 0u);
+
+  // A read that starts in the window takes what is there, and the rest from
+  // the device.
+  checkRead_(cache, 0, 1);
+  device.resetStats();
+  cache.resetStats();
+  checkRead_(cache, kWindow - 2, 4);
+  RB_CHECK_EQ(cache.stats().hits, 2u);
+  RB_CHECK_EQ(device.stats().commands, 1);
+
+  // A sector out of the way is cached on its own, and read again from memory.
+  device.resetStats();
+  checkRead_(cache, 40, 1);
+  checkRead_(cache, 20, 1);
+  checkRead_(cache, 40, 1);
+  RB_CHECK_EQ(device.stats().commands, 2);
+
+  // Writes drop the cached copies of the sectors they touch.
+  std::vector<std::uint8_t> sector(kSector, 0xa5);
+  RB_CHECK_EQ(cache.program(sector.data(), 40 * kSector, kSector), 0);
+  RB_CHECK_EQ(cache.program(sector.data(), 1 * kSector, kSector), 0);
+  for (std::uint32_t s : {40u, 1u}) {
+    std::vector<std::uint8_t> out(kSector);
+    RB_CHECK_EQ(cache.read(out.data(), s * kSector, kSector), 0);
+    RB_CHECK(out == sector);
+  }
+  checkRead_(cache, 20, 1);
+
+  // Reads off sector boundaries are passed on as they are, and this device
+  // refuses them.
+  std::uint8_t out[kSector];
+  device.resetStats();
+  RB_CHECK_EQ(cache.read(out, 100, kSector), BD_ERROR_DEVICE_ERROR);
+  RB_CHECK_EQ(device.stats().commands, 0);
+  return rb::test::result();
+}
@@ -0,0 +1,122 @@
+/// \file CachedReadBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of reading a file through rb::CachedBlockDevice, against
+/// a file-backed block device with the latency of an SD card over SPI.
+///
+/// \details Two patterns are read: a file a sector at a time, as FatFs reads
+/// partial sectors and the FAT, and a file in stream-read-sized runs of whole
+/// sectors, as the reader thread streams it. For each are reported the host
+/// throughput, the commands sent to the card, the bytes the cache copied, and
+/// the modeled throughput on the card.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "Bench.hpp"
+#include "CachedBlockDevice.hpp"
+#include "Check.hpp"
+#include "FileBlockDevice.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+constexpr std::size_t kSector = rb::CachedBlockDevice::kSectorSize;
+
+/// \brief Size of the file.
+constexpr std::size_t kFileSize = 4 << 20;
+
+/// \brief Bytes per request of the stream, MUSIC_PLAYER_STREAM_READ_SIZE.
+constexpr std::size_t kReadSize = 1024;
+
+/// \brief Runs of each pattern. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief Figures of a pattern.
+struct Result_
+{
+  double mb_s;        // Host throughput.
+  double commands_kb; // Device commands per KB.
+  double copied_kb;   // Bytes copied out of the cache per KB.
+  double card_kb_s;   // Modeled throughput on the card.
+};
+
+/// \brief Time a pattern of reads of the whole file in requests of a size,
+/// and check what it read.
+Result_
+time_(
+  std::size_t                      request,
+  rb::test::FileBlockDevice&       device,
+  const std::vector<std::uint8_t>& data)
+{
+  std::vector<std::uint8_t> out(kFileSize);
+  double                    best = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    rb::CachedBlockDevice cache(&device);
+    device.resetStats();
+    const double start = rb::test::now();
+    for (std::size_t pos = 0; pos < kFileSize; pos += request)
+      cache.read(out.data() + pos, pos, request);
+    best = std::min(best, rb::test::now() - start);
+    rb::test::keep(out.data());
+
+    if (r == kRuns - 1) {
+      const double                            kb    = kFileSize / 1024.0;
+      const rb::test::FileBlockDevice::Stats& stats = device.stats();
+      RB_CHECK(out == data);
+      return {
+        kFileSize / best / (1 << 20),
+        stats.commands / kb,
+        cache.stats().hits * double(kSector) / kb,
+        kb / (stats.card_us / 1e6)};
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<std::uint8_t> data(kFileSize);
+  for (std::size_t i = 0; i < kFileSize; ++i)
+    data[i] = static_cast<std::uint8_t>(i * 131 + (i >> 9));
+  rb::test::FileBlockDevice device(data.data(), data.size());
+
+  const Result_ sectors = time_(kSector, device, data);
+  const Result_ stream  = time_(kReadSize, device, data);
+
+  std::printf(
+    "%-16s %12s %14s %14s %14s\n",
+    "pattern",
+    "host MB/s",
+    "commands/KB",
+    "copied B/KB",
+    "card KB/s");
+  for (const auto& [name, r] : {
+         std::make_pair("single sectors", sectors),
+         std::make_pair("stream", stream)})
+    std::printf(
+      "%-16s %12.0f %14.3f %14.0f %14.0f\n",
+      name,
+      r.mb_s,
+      r.commands_kb,
+      r.copied_kb,
+      r.card_kb_s);
+
+  // Single sectors are read ahead a window at a time. The stream goes straight
+  // into the caller's buffer, one command per request, with no copy.
+  constexpr double kWindowKb = rb::CachedBlockDevice::kWindowSectors / 2.0;
+  RB_CHECK(sectors.commands_kb < 1.01 / kWindowKb);
+  RB_CHECK(stream.commands_kb < 1.01 / (kReadSize / 1024.0));
+  RB_CHECK_EQ(stream.copied_kb, 0);
+  return rb::test::result();
+}
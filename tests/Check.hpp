@@ -0,0 +1,104 @@
+/// \file Check.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Checks for the host tests.
+
+#ifndef RB_TESTS_CHECK_HPP
+#define RB_TESTS_CHECK_HPP
+
+#ifndef __cplusplus
+#error "Check.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdio>
+
+// ======================= Public Interface ==========================
+
+/// \brief Check a condition, and report it if it does not hold. The test goes
+/// on either way, and fails at the end.
+#define RB_CHECK(cond)                                                         \
+  ::rb::test::check(static_cast<bool>(cond), #cond, __FILE__, __LINE__)
+
+/// \brief Check that two integers are equal, and report both if they are not.
+#define RB_CHECK_EQ(a, b)                                                      \
+  ::rb::test::checkEq(                                                         \
+    static_cast<long long>(a),                                                 \
+    static_cast<long long>(b),                                                 \
+    #a " == " #b,                                                              \
+    __FILE__,                                                                  \
+    __LINE__)
+
+namespace rb {
+namespace test {
+
+/// \brief Record the outcome of a check.
+///
+/// \return cond.
+bool
+check(bool cond, const char* expr, const char* file, int line);
+
+/// \brief Record the outcome of an equality check.
+///
+/// \return Whether a and b are equal.
+bool
+checkEq(long long a, long long b, const char* expr, const char* file, int line);
+
+/// \brief Get the exit status of the test, to return from main().
+int
+result();
+
+} // namespace test
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+namespace test {
+
+namespace detail {
+
+/// \brief Number of failed checks.
+inline int failures = 0;
+
+} // namespace detail
+
+inline bool
+check(bool cond, const char* expr, const char* file, int line)
+{
+  if (!cond) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    ++detail::failures;
+  }
+  return cond;
+}
+
+inline bool
+checkEq(long long a, long long b, const char* expr, const char* file, int line)
+{
+  if (a != b) {
+    std::fprintf(
+      stderr,
+      "%s:%d: check failed: %s (%lld vs %lld)\n",
+      file,
+      line,
+      expr,
+      a,
+      b);
+    ++detail::failures;
+  }
+  return a == b;
+}
+
+inline int
+result()
+{
+  if (detail::failures)
+    std::fprintf(stderr, "%d check(s) failed\n", detail::failures);
+  return detail::failures ? 1 : 0;
+}
+
+} // namespace test
+} // namespace rb
+
+#endif // RB_TESTS_CHECK_HPP
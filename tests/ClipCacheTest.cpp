@@ -0,0 +1,194 @@
+/// \file ClipCacheTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::ClipCache: least recently used eviction, pinning, and
+/// clip data surviving the block chains getting interleaved.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Check.hpp"
+#include "ClipCache.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+constexpr std::size_t kBlock = rb::ClipCache::kBlockSize;
+
+/// \brief Byte at an offset of a clip's test data.
+std::uint8_t
+byteOf_(const char* name, std::size_t offset)
+{
+  return static_cast<std::uint8_t>(name[0] * 31 + offset * 7 + offset / 251);
+}
+
+/// \brief Insert a clip and fill it, the way the reader thread does.
+///
+/// \param pin Leave the clip pinned.
+///
+/// \return The clip id, or -1 if it could not be cached.
+int
+put_(rb::ClipCache& cache, const char* name, std::size_t size, bool pin = false)
+{
+  const int clip = cache.insert(name, size);
+  if (clip < 0)
+    return clip;
+  std::size_t   offset = 0;
+  std::uint8_t* span;
+  while (std::size_t n = cache.writeSpan(clip, offset, span)) {
+    for (std::size_t i = 0; i < n; ++i)
+      span[i] = byteOf_(name, offset + i);
+    offset += n;
+  }
+  RB_CHECK_EQ(offset, size);
+  cache.publish(clip);
+  if (!pin)
+    cache.release(clip);
+  return clip;
+}
+
+/// \brief Check that a clip is in the cache and holds its data, reading it
+/// back in odd sized pieces that straddle the blocks.
+void
+checkClip_(rb::ClipCache& cache, const char* name, std::size_t size)
+{
+  const int clip = cache.acquire(name);
+  if (!RB_CHECK(clip >= 0))
+    return;
+  std::vector<std::uint8_t> data(size + 1);
+  std::size_t               offset = 0;
+  while (std::size_t n = cache.read(clip, offset, data.data() + offset, 97))
+    offset += n;
+  RB_CHECK_EQ(offset, size);
+  bool ok = true;
+  for (std::size_t i = 0; i < size; ++i)
+    ok &= data[i] == byteOf_(name, i);
+  RB_CHECK(ok);
+  cache.release(clip);
+}
+
+/// \brief The least recently used clip goes first, where use is a hit as well
+/// as the insert.
+void
+testLru_()
+{
+  std::uint8_t  storage[8 * kBlock];
+  rb::ClipCache cache(storage, sizeof(storage));
+  RB_CHECK_EQ(cache.capacity(), sizeof(storage));
+
+  put_(cache, "a", 3 * kBlock);
+  put_(cache, "b", 3 * kBlock - 10);
+  checkClip_(cache, "a", 3 * kBlock); // a is now more recent than b.
+  RB_CHECK_EQ(cache.stats().used, 6 * kBlock);
+
+  put_(cache, "c", 2 * kBlock + 1); // Needs 3 blocks of the 2 left.
+  RB_CHECK_EQ(cache.acquire("b"), -1);
+  checkClip_(cache, "a", 3 * kBlock);
+  checkClip_(cache, "c", 2 * kBlock + 1);
+
+  const rb::ClipCache::Stats stats = cache.stats();
+  RB_CHECK_EQ(stats.evictions, 1);
+  RB_CHECK_EQ(stats.hits, 3);
+  RB_CHECK_EQ(stats.misses, 1);
+  RB_CHECK_EQ(stats.used, 6 * kBlock);
+}
+
+/// \brief A pinned clip is never evicted, and an insert that cannot make room
+/// without it fails.
+void
+testPinned_()
+{
+  std::uint8_t  storage[8 * kBlock];
+  rb::ClipCache cache(storage, sizeof(storage));
+
+  put_(cache, "a", 3 * kBlock, true);
+  put_(cache, "b", 3 * kBlock);
+  RB_CHECK_EQ(cache.insert("c", 6 * kBlock), -1);
+  checkClip_(cache, "a", 3 * kBlock);
+
+  // Unpinned, it goes like any other.
+  const int a = cache.acquire("a");
+  cache.release(a);
+  cache.release(a);
+  RB_CHECK(put_(cache, "c", 6 * kBlock) >= 0);
+  RB_CHECK_EQ(cache.acquire("a"), -1);
+  checkClip_(cache, "c", 6 * kBlock);
+}
+
+/// \brief Clips bigger than the cache, or with names too long, are never
+/// cached, and evict nothing trying.
+void
+testTooBig_()
+{
+  std::uint8_t  storage[8 * kBlock];
+  rb::ClipCache cache(storage, sizeof(storage));
+
+  put_(cache, "a", kBlock);
+  RB_CHECK_EQ(cache.insert("b", 8 * kBlock + 1), -1);
+  char name[rb::ClipCache::kNameSize + 1] = {};
+  for (std::size_t i = 0; i < rb::ClipCache::kNameSize; ++i)
+    name[i] = 'n';
+  RB_CHECK_EQ(cache.insert(name, 1), -1);
+  RB_CHECK_EQ(cache.stats().evictions, 0);
+  checkClip_(cache, "a", kBlock);
+}
+
+/// \brief Once every slot is taken, small clips evict one another even with
+/// blocks to spare, and evictions leave the free blocks scattered through the
+/// storage.
+void
+testSlotsAndChains_()
+{
+  constexpr int kClips = rb::ClipCache::kMaxClips;
+
+  std::uint8_t  storage[2 * kClips * kBlock];
+  rb::ClipCache cache(storage, sizeof(storage));
+
+  char names[kClips + 8][2];
+  for (int i = 0; i < kClips + 8; ++i) {
+    names[i][0] = static_cast<char>('A' + i);
+    names[i][1] = '\0';
+  }
+  for (int i = 0; i < kClips; ++i)
+    put_(cache, names[i], kBlock / 2);
+  RB_CHECK_EQ(cache.stats().used, kClips * kBlock);
+
+  // Touch the even clips, so that the odd ones are evicted first.
+  for (int i = 0; i < kClips; i += 2)
+    cache.release(cache.acquire(names[i]));
+  for (int i = kClips; i < kClips + 8; ++i)
+    put_(cache, names[i], kBlock / 2);
+  for (int i = 1; i < kClips; i += 2)
+    RB_CHECK_EQ(cache.acquire(names[i]), -1);
+  RB_CHECK_EQ(cache.stats().evictions, 8);
+
+  // The free blocks are now interleaved with the ones in use, so a clip
+  // spanning several of them is chained through the gaps. It takes the slot of
+  // the oldest clip left.
+  for (int i = 0; i < kClips; i += 2)
+    checkClip_(cache, names[i], kBlock / 2);
+  RB_CHECK(put_(cache, "big", 9 * kBlock + 5) >= 0);
+  checkClip_(cache, "big", 9 * kBlock + 5);
+  RB_CHECK_EQ(cache.acquire(names[kClips]), -1);
+  for (int i = 0; i < kClips; i += 2)
+    checkClip_(cache, names[i], kBlock / 2);
+  for (int i = kClips + 1; i < kClips + 8; ++i)
+    checkClip_(cache, names[i], kBlock / 2);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  testLru_();
+  testPinned_();
+  testTooBig_();
+  testSlotsAndChains_();
+  return rb::test::result();
+}
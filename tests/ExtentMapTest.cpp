@@ -0,0 +1,126 @@
+/// \file ExtentMapTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::ExtentMap: reads of a fragmented file across its runs
+/// of sectors, with partial head and tail sectors, and the mapping being
+/// dropped when the file is too fragmented.
+
+#include <cstdint>
+#include <vector>
+
+#include "Check.hpp"
+#include "ExtentMap.hpp"
+#include "FileBlockDevice.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+constexpr std::uint32_t kSector = rb::test::FileBlockDevice::kSectorSize;
+
+/// \brief Sectors of the device.
+constexpr std::uint32_t kDeviceSectors = 256;
+
+/// \brief Runs of sectors of the file, out of order on the device, the first
+/// two consecutive so that they join.
+constexpr rb::ExtentMap::Extent kRuns[] = {
+  {100, 4},
+  {104, 2},
+  {10, 3},
+  {200, 1},
+  {50, 6},
+};
+
+/// \brief Size of the file, ending partway into its last sector.
+constexpr std::uint32_t kFileSize = (4 + 2 + 3 + 1 + 6 - 1) * kSector + 100;
+
+/// \brief Byte at an offset of the device.
+std::uint8_t
+byteOf_(std::size_t offset)
+{
+  return static_cast<std::uint8_t>(offset * 7 + offset / 509);
+}
+
+/// \brief Map the test file.
+bool
+map_(rb::ExtentMap& map, mbed::BlockDevice& device)
+{
+  bool ok = map.start(&device, kSector, kFileSize);
+  for (const auto& run : kRuns)
+    ok = ok && map.add(run.sector, run.count);
+  return ok;
+}
+
+/// \brief Check a read of the test file against the device.
+void
+checkRead_(
+  const rb::ExtentMap&              map,
+  const std::vector<std::uint32_t>& file,
+  std::uint32_t                     pos,
+  std::size_t                       n)
+{
+  std::vector<std::uint8_t> out(n);
+  if (!RB_CHECK(map.read(pos, out.data(), n)))
+    return;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (!RB_CHECK_EQ(out[i], byteOf_(file[pos + i])))
+      return;
+  }
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<std::uint8_t> data(kDeviceSectors * kSector);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = byteOf_(i);
+  rb::test::FileBlockDevice device(data.data(), data.size());
+
+  // Device offset of each byte of the file.
+  std::vector<std::uint32_t> file;
+  for (const auto& run : kRuns) {
+    for (std::uint32_t i = 0; i < run.count * kSector; ++i)
+      file.push_back(run.sector * kSector + i);
+  }
+
+  rb::ExtentMap map;
+  RB_CHECK(map_(map, device));
+  RB_CHECK(map.mapped());
+  RB_CHECK_EQ(map.sectors(), 16u);
+
+  // The whole file, then pieces that straddle the runs and start and end off
+  // sector boundaries.
+  checkRead_(map, file, 0, kFileSize);
+  checkRead_(map, file, 1, kFileSize - 1);
+  checkRead_(map, file, 5 * kSector + 17, 3 * kSector);
+  checkRead_(map, file, 9 * kSector, kSector);
+  checkRead_(map, file, 9 * kSector + 511, 2);
+  checkRead_(map, file, kFileSize - 1, 1);
+
+  // Whole sectors of the joined run are read in one command.
+  std::vector<std::uint8_t> out(6 * kSector);
+  device.resetStats();
+  RB_CHECK(map.read(0, out.data(), out.size()));
+  RB_CHECK_EQ(device.stats().commands, 1);
+
+  // Nothing past the end of the file.
+  RB_CHECK(!map.read(kFileSize - 1, out.data(), 2));
+
+  // A file of more runs than fit is not mapped.
+  RB_CHECK(map.start(&device, kSector, kDeviceSectors * kSector / 2));
+  bool ok = true;
+  for (int i = 0; ok && i <= rb::ExtentMap::kMaxExtents; ++i)
+    ok = map.add(2 * i, 1);
+  RB_CHECK(!ok);
+  RB_CHECK(!map.mapped());
+
+  // Sectors the device cannot read one by one are refused.
+  RB_CHECK(!map.start(&device, kSector / 2, kFileSize));
+  RB_CHECK(!map.start(&device, 2 * rb::ExtentMap::kMaxSectorSize, kFileSize));
+  return rb::test::result();
+}
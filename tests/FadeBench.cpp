@@ -0,0 +1,156 @@
+/// \file FadeBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of the gain and fade of the voices folded into the mix
+/// pass, against applying them in passes of their own over the samples.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "Mixer.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Samples mixed at once, kMixChunk of the MusicPlayer.
+constexpr int kChunk = 32;
+
+/// \brief Samples mixed per run.
+constexpr long kSamples = 1 << 22;
+
+/// \brief Runs of each variant. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief Gain of the voice, Q8.
+constexpr int kGain = 200;
+
+/// \brief Decoded samples the voice cycles through.
+constexpr int kSource = 4096;
+
+/// \brief Fade the variants run, over all of kSamples.
+void
+startFade_(rb::Fade& fade, rb::Fade::Curve curve)
+{
+  fade.set(0);
+  fade.start(rb::Fade::kUnity, kSamples, curve);
+}
+
+/// \brief Mix a voice with its gain and fade stepped in the resampling loop,
+/// the way mixVoice_ does.
+///
+/// \param acc Mix of kSamples samples.
+void
+fused_(const std::vector<int>& source, rb::Fade::Curve curve, std::int32_t* acc)
+{
+  rb::VoiceMixer mixer;
+  rb::Fade       fade;
+  startFade_(fade, curve);
+  int pos = 0;
+  mixer.prime(source[pos++]);
+  mixer.setRates(22050, 24000);
+  for (long done = 0; done < kSamples; done += kChunk)
+    mixer.mix(fade, kGain, acc + done, kChunk, [&](int& s) {
+      s = source[pos++ & (kSource - 1)];
+      return true;
+    });
+}
+
+/// \brief Mix a voice in three passes per chunk: resample it into a buffer,
+/// scale the buffer by the gain and fade, and add it into the mix.
+void
+separate_(
+  const std::vector<int>& source,
+  rb::Fade::Curve         curve,
+  std::int32_t*           acc)
+{
+  // The resampler of the fused variant at unity gain, with no fade, so that
+  // only the gain and fade move to a pass of their own.
+  rb::VoiceMixer mixer;
+  rb::Fade       unity;
+  rb::Fade       fade;
+  startFade_(fade, curve);
+  int pos = 0;
+  mixer.prime(source[pos++]);
+  mixer.setRates(22050, 24000);
+
+  std::int32_t tmp[kChunk];
+  for (long done = 0; done < kSamples; done += kChunk) {
+    std::fill(tmp, tmp + kChunk, 0);
+    mixer.mix(unity, 256, tmp, kChunk, [&](int& s) {
+      s = source[pos++ & (kSource - 1)];
+      return true;
+    });
+    for (int i = 0; i < kChunk; ++i) {
+      const int level = (kGain * (fade.next() >> 4)) >> 8; // Q12.
+      tmp[i]          = (tmp[i] * level) >> 12;
+    }
+    for (int i = 0; i < kChunk; ++i)
+      acc[done + i] += tmp[i];
+  }
+}
+
+/// \brief Time a variant over kRuns runs.
+///
+/// \return The fewest timestamp cycles per sample of any run.
+template<typename F>
+double
+time_(
+  F&&                        variant,
+  const std::vector<int>&    source,
+  rb::Fade::Curve            curve,
+  std::vector<std::int32_t>& acc)
+{
+  double best = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    std::fill(acc.begin(), acc.end(), 0);
+    const std::uint64_t start = rb::test::cycles();
+    variant(source, curve, acc.data());
+    rb::test::keep(acc[kSamples - 1]);
+    best = std::min<double>(best, rb::test::cycles() - start);
+  }
+  return best / kSamples;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<int> source(kSource);
+  for (int i = 0; i < kSource; ++i)
+    source[i] = static_cast<int>((i * 2654435761u) >> 16 & 0x7FFF) - 0x4000;
+
+  std::vector<std::int32_t> a(kSamples);
+  std::vector<std::int32_t> b(kSamples);
+
+  std::printf("%-12s %14s %14s %10s\n", "fade", "fused", "separate", "saved");
+  for (rb::Fade::Curve curve : {rb::Fade::Linear, rb::Fade::Exponential}) {
+    const double fused    = time_(fused_, source, curve, a);
+    const double separate = time_(separate_, source, curve, b);
+
+    // Both have to mix the same samples, give or take the rounding of scaling
+    // after interpolating rather than before.
+    long off = 0;
+    for (long i = 0; i < kSamples; ++i)
+      off += std::abs(a[i] - b[i]) > 1;
+    RB_CHECK_EQ(off, 0);
+
+    std::printf(
+      "%-12s %14.2f %14.2f %9.0f%%\n",
+      curve == rb::Fade::Linear ? "linear" : "exponential",
+      fused,
+      separate,
+      100 * (1 - fused / separate));
+  }
+  std::printf("(timestamp cycles per sample)\n");
+  return rb::test::result();
+}
@@ -0,0 +1,130 @@
+/// \file FileBlockDevice.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Block device backed by a host file, with a model of the time an SD
+/// card over SPI would take for the same commands.
+
+#ifndef RB_TESTS_FILE_BLOCK_DEVICE_HPP
+#define RB_TESTS_FILE_BLOCK_DEVICE_HPP
+
+#ifndef __cplusplus
+#error "FileBlockDevice.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+#include <cstdio>
+
+#include <BlockDevice.h>
+#include <unistd.h>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+namespace test {
+
+/// \brief Block device of 512-byte sectors in a temporary host file.
+///
+/// Every read is one command, as a multi-block read is on the card. Besides
+/// doing the read, each command adds to a modeled card time: an access time
+/// per command, and a transfer time per byte. Programs are not counted.
+class FileBlockDevice : public mbed::BlockDevice
+{
+ public:
+  /// \brief Size of a sector in bytes.
+  static constexpr bd_size_t kSectorSize = 512;
+
+  /// \brief Access time of a command in microseconds, from sending it to the
+  /// first byte, as for SD cards over SPI.
+  static constexpr double kAccessUs = 300;
+
+  /// \brief Transfer time per byte in microseconds, SPI at 12.5 MHz.
+  static constexpr double kByteUs = 8 / 12.5;
+
+  /// \brief Counts of what the device was asked for.
+  struct Stats
+  {
+    long   commands;
+    long   bytes;
+    double card_us; // Modeled time on the card.
+  };
+
+  /// \brief Constructor.
+  ///
+  /// \param data Contents of the device, padded to whole sectors.
+  FileBlockDevice(const void* data, std::size_t size);
+
+  ~FileBlockDevice() override;
+
+  /// \brief Get the counts since the last reset.
+  const Stats& stats() const { return _stats; }
+
+  /// \brief Reset the counts.
+  void resetStats() { _stats = {}; }
+
+  int init() override { return 0; }
+  int deinit() override { return 0; }
+  int read(void* buffer, bd_addr_t addr, bd_size_t size) override;
+  int program(const void* buffer, bd_addr_t addr, bd_size_t size) override;
+
+  bd_size_t   get_read_size() const override { return kSectorSize; }
+  bd_size_t   get_program_size() const override { return kSectorSize; }
+  bd_size_t   size() const override { return _size; }
+  const char* get_type() const override { return "FILE"; }
+
+ private:
+  std::FILE* _file;
+  bd_size_t  _size;
+  Stats      _stats = {};
+};
+
+} // namespace test
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+namespace rb {
+namespace test {
+
+inline FileBlockDevice::FileBlockDevice(const void* data, std::size_t size) :
+    _file(std::tmpfile()),
+    _size((size + kSectorSize - 1) / kSectorSize * kSectorSize)
+{
+  std::fwrite(data, 1, size, _file);
+  for (std::size_t i = size; i < _size; ++i)
+    std::fputc(0, _file);
+  std::fflush(_file);
+}
+
+inline FileBlockDevice::~FileBlockDevice()
+{
+  std::fclose(_file);
+}
+
+inline int
+FileBlockDevice::read(void* buffer, bd_addr_t addr, bd_size_t size)
+{
+  if (addr % kSectorSize || size % kSectorSize || addr + size > _size)
+    return BD_ERROR_DEVICE_ERROR;
+  if (pread(fileno(_file), buffer, size, addr) != static_cast<ssize_t>(size))
+    return BD_ERROR_DEVICE_ERROR;
+  ++_stats.commands;
+  _stats.bytes += size;
+  _stats.card_us += kAccessUs + size * kByteUs;
+  return 0;
+}
+
+inline int
+FileBlockDevice::program(const void* buffer, bd_addr_t addr, bd_size_t size)
+{
+  if (addr % kSectorSize || size % kSectorSize || addr + size > _size)
+    return BD_ERROR_DEVICE_ERROR;
+  if (pwrite(fileno(_file), buffer, size, addr) != static_cast<ssize_t>(size))
+    return BD_ERROR_DEVICE_ERROR;
+  return 0;
+}
+
+} // namespace test
+} // namespace rb
+
+#endif // RB_TESTS_FILE_BLOCK_DEVICE_HPP
@@ -0,0 +1,147 @@
+/// \file MixerBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of the mixing stage of the MusicPlayer: cycles per mixed
+/// sample with 2, 4 and 8 voices playing, each resampled and fading.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "Mixer.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Samples per bank, the most the bank size adapts up to.
+constexpr int kBankSamples = 256;
+
+/// \brief Samples mixed at once, kMixChunk of the MusicPlayer.
+constexpr int kMixChunk = 32;
+
+/// \brief Banks mixed per run.
+constexpr int kBanks = 4096;
+
+/// \brief Runs of each voice count. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief Rate of the mix.
+constexpr int kMixRate = 24000;
+
+/// \brief Rates of the voices, in turn, so most of them are resampled.
+constexpr int kRates[] = { 24000, 22050, 16000, 44100 };
+
+/// \brief Decoded samples a voice cycles through.
+constexpr int kSource = 4096;
+
+/// \brief A voice being mixed, taking its samples from a shared buffer.
+struct Voice_
+{
+  rb::VoiceMixer mixer;
+  rb::Fade       fade;
+  int            pos;
+};
+
+/// \brief Mix kBanks banks of some voices, the way mixBank_ does.
+///
+/// \return The sum of the DAC samples.
+std::uint32_t
+mix_(std::vector<Voice_>& voices, const std::vector<int>& source)
+{
+  std::uint16_t bank[kBankSamples];
+  std::int32_t  acc[kMixChunk];
+  std::uint32_t sum = 0;
+  for (int b = 0; b < kBanks; ++b) {
+    for (int done = 0; done < kBankSamples; done += kMixChunk) {
+      std::fill(acc, acc + kMixChunk, 0);
+      for (Voice_& v : voices) {
+        v.mixer.mix(v.fade, 192, acc, kMixChunk, [&](int& sample) {
+          sample = source[v.pos++ & (kSource - 1)];
+          return true;
+        });
+      }
+      rb::mixDown(acc, bank + done, kMixChunk);
+    }
+    sum += bank[0] + bank[kBankSamples - 1];
+  }
+  return sum;
+}
+
+/// \brief Time the mix of some voices over kRuns runs.
+///
+/// \return The fewest timestamp cycles per mixed sample of any run.
+double
+time_(int count, const std::vector<int>& source)
+{
+  double best = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    std::vector<Voice_> voices(count);
+    for (int i = 0; i < count; ++i) {
+      Voice_& v = voices[i];
+      v.pos     = i * 977;
+      v.mixer.prime(source[v.pos++]);
+      v.mixer.setRates(kRates[i % 4], kMixRate);
+      // Voices fading in and out all the way through, so that the fade is
+      // stepped as it is at its most expensive.
+      v.fade.set(i % 2 ? rb::Fade::kUnity : 0);
+      v.fade.start(
+        i % 2 ? 0 : rb::Fade::kUnity,
+        static_cast<long>(kBanks) * kBankSamples,
+        i % 4 < 2 ? rb::Fade::Exponential : rb::Fade::Linear);
+    }
+    const std::uint64_t start = rb::test::cycles();
+    rb::test::keep(mix_(voices, source));
+    best = std::min<double>(best, rb::test::cycles() - start);
+  }
+  return best / (static_cast<double>(kBanks) * kBankSamples);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<int> source(kSource);
+  for (int i = 0; i < kSource; ++i)
+    source[i] = static_cast<int>((i * 2654435761u) >> 16 & 0x3FFF) - 0x2000;
+
+  // The mix has to be right before it is worth timing: two voices at the mix
+  // rate, at full gain with no fade, cancelling out, mix to silence.
+  {
+    std::vector<int>    negated(kSource);
+    std::vector<Voice_> voices(2);
+    std::transform(source.begin(), source.end(), negated.begin(), [](int s) {
+      return -s;
+    });
+    std::uint16_t bank[kMixChunk];
+    std::int32_t  acc[kMixChunk] = {};
+    for (int i = 0; i < 2; ++i) {
+      const std::vector<int>& from = i ? negated : source;
+      voices[i].mixer.prime(from[0]);
+      voices[i].mixer.setRates(kMixRate, kMixRate);
+      voices[i].pos = 1;
+      voices[i].mixer.mix(voices[i].fade, 256, acc, kMixChunk, [&](int& s) {
+        s = from[voices[i].pos++];
+        return true;
+      });
+    }
+    rb::mixDown(acc, bank, kMixChunk);
+    RB_CHECK(std::all_of(bank, bank + kMixChunk, [](std::uint16_t s) {
+      return s == 0x8000;
+    }));
+  }
+
+  std::printf("%-8s %16s %16s\n", "voices", "cycles/sample", "cycles/voice");
+  for (int count : { 2, 4, 8 }) {
+    const double cycles = time_(count, source);
+    std::printf("%-8d %16.2f %16.2f\n", count, cycles, cycles / count);
+  }
+  return rb::test::result();
+}
@@ -0,0 +1,154 @@
+/// \file MixerTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of the mixing stage: pass-through at the bank rate, a starved
+/// voice going on right where it stopped, and saturation.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Check.hpp"
+#include "Mixer.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Signed test sample at an index.
+int
+sampleOf_(int i)
+{
+  return static_cast<int>((i * 2654435761u) >> 17) - 0x4000;
+}
+
+/// \brief A voice's samples, optionally running dry every so often.
+struct Source_
+{
+  int  pos        = 0;
+  int  starve_in  = 0; // Samples until running dry, or 0 never to.
+  int  starve_gap = 0;
+  long starved    = 0;
+
+  bool operator()(int& sample)
+  {
+    if (starve_gap && --starve_in == 0) {
+      starve_in = starve_gap;
+      ++starved;
+      return false;
+    }
+    sample = sampleOf_(pos++);
+    return true;
+  }
+};
+
+/// \brief At the bank rate and full gain, the samples pass through unchanged,
+/// one sample late.
+void
+testPassThrough_()
+{
+  constexpr int kCount = 100;
+
+  rb::VoiceMixer mixer;
+  rb::Fade       fade;
+  Source_        source;
+  std::int32_t   acc[kCount] = {};
+
+  int first;
+  source(first);
+  mixer.prime(first);
+  mixer.setRates(24000, 24000);
+  RB_CHECK_EQ(mixer.mix(fade, 256, acc, kCount, source), kCount);
+
+  int mismatches = acc[0] != sampleOf_(0);
+  for (int i = 1; i < kCount; ++i)
+    mismatches += acc[i] != sampleOf_(i - 1);
+  RB_CHECK_EQ(mismatches, 0);
+}
+
+/// \brief Mix a voice resampled and fading in, in chunks the way mixBank_
+/// does, picking up where it stopped each time its source runs dry.
+///
+/// \return The mix.
+std::vector<std::int32_t>
+mixResampled_(Source_ source, int count)
+{
+  constexpr int kChunk = 32;
+
+  rb::VoiceMixer mixer;
+  rb::Fade       fade;
+  fade.set(0);
+  fade.start(rb::Fade::kUnity, count / 2, rb::Fade::Exponential);
+
+  int first;
+  while (!source(first)) {
+  }
+  mixer.prime(first);
+  mixer.setRates(22050, 24000);
+
+  std::vector<std::int32_t> acc(count);
+  for (int done = 0; done < count;) {
+    const int n = std::min(kChunk, count - done);
+    done += mixer.mix(fade, 200, acc.data() + done, n, source);
+  }
+  return acc;
+}
+
+/// \brief A voice that runs dry mid-chunk, and even before its first sample of
+/// a chunk, mixes the same samples as one that never does.
+void
+testStarveResume_()
+{
+  constexpr int kCount = 5000;
+
+  Source_ starving;
+  starving.starve_in  = 7;
+  starving.starve_gap = 13;
+
+  const std::vector<std::int32_t> smooth  = mixResampled_(Source_(), kCount);
+  const std::vector<std::int32_t> resumed = mixResampled_(starving, kCount);
+  RB_CHECK(smooth == resumed);
+
+  // Starving at the very start of a mix leaves the voice as it was.
+  rb::VoiceMixer mixer;
+  rb::Fade       fade;
+  std::int32_t   acc[4] = {};
+  mixer.prime(100);
+  mixer.setRates(48000, 24000);
+  RB_CHECK_EQ(mixer.mix(fade, 256, acc, 4, [](int&) { return false; }), 1);
+  RB_CHECK_EQ(acc[0], 100);
+  int next = 200;
+  RB_CHECK_EQ(
+    mixer.mix(fade, 256, acc + 1, 3, [&](int& s) { return s = next++, true; }),
+    3);
+  RB_CHECK_EQ(acc[1], 200);
+  RB_CHECK_EQ(acc[2], 202);
+}
+
+/// \brief The mix saturates to the 16-bit range instead of wrapping.
+void
+testMixDown_()
+{
+  const std::int32_t acc[5] = { -100000, -0x8000, 0, 0x7FFF, 100000 };
+  std::uint16_t      out[5];
+  rb::mixDown(acc, out, 5);
+  RB_CHECK_EQ(out[0], 0x0000);
+  RB_CHECK_EQ(out[1], 0x0000);
+  RB_CHECK_EQ(out[2], 0x8000);
+  RB_CHECK_EQ(out[3], 0xFFC0);
+  RB_CHECK_EQ(out[4], 0xFFC0);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  testPassThrough_();
+  testStarveResume_();
+  testMixDown_();
+  return rb::test::result();
+}
@@ -0,0 +1,132 @@
+/// \file NodeMcuReplyBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of collecting a weatherapi.com response from the wifi
+/// module, replayed through rb::NodeMcuReply in spans of the receive ring,
+/// against the byte at a time strncat() it replaced.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "NodeMcuReply.hpp"
+#include "NodeMcuTranscript.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Size of the response buffer of the firmware.
+constexpr std::size_t kRespSize = 2048;
+
+/// \brief Size of the receive ring of WifiClient, the largest span.
+constexpr std::size_t kSpan = 512;
+
+/// \brief Replays per run.
+constexpr int kReplays = 50;
+
+/// \brief Runs of each path. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief Collect the response the way getreply_json() did: a byte at a time,
+/// appended with strncat().
+std::size_t
+collectStrncat_(const std::string& received, char* resp, std::size_t size)
+{
+  resp[0]   = '\0';
+  int depth = 0;
+  for (std::size_t i = 0; i < received.size(); ++i) {
+    const char c = received[i];
+    if (c == '{')
+      ++depth;
+    if (depth > 0 && std::strlen(resp) < size - 1)
+      std::strncat(resp, &c, 1);
+    if (c == '}' && depth > 0 && --depth == 0)
+      return i + 1;
+  }
+  return received.size();
+}
+
+/// \brief Collect the response through the reply parser, in ring spans.
+std::size_t
+collectReply_(const std::string& received, char* resp, std::size_t size)
+{
+  rb::NodeMcuReply reply(
+    resp, size, rb::NodeMcuReply::LineStart, nullptr, true);
+  std::size_t taken = 0;
+  while (taken < received.size() && reply.state != rb::NodeMcuReply::Done) {
+    const std::size_t n = std::min(kSpan, received.size() - taken);
+    taken += reply.feed(received.data() + taken, n);
+  }
+  return taken;
+}
+
+/// \brief Time a path, and get its output.
+///
+/// \return Nanoseconds per byte of the transcript.
+template<typename F>
+double
+time_(F&& collect, const std::string& received, std::vector<char>& resp)
+{
+  double best = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    const double start = rb::test::now();
+    for (int i = 0; i < kReplays; ++i)
+      rb::test::keep(collect(received, resp.data(), resp.size()));
+    best = std::min(best, rb::test::now() - start);
+  }
+  return best / kReplays / received.size() * 1e9;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  const std::string received =
+    rb::test::receiveTranscript(rb::test::weatherResponse(
+      rb::test::weatherBody()));
+
+  // The firmware's buffer, and one that takes the whole body.
+  std::printf("transcript: %zu bytes\n", received.size());
+  std::printf("%-16s %10s %12s %12s\n", "path", "buffer", "ns/byte", "MB/s");
+  double old_ns[2];
+  double new_ns[2];
+  int    i = 0;
+  for (std::size_t size : {kRespSize, received.size()}) {
+    std::vector<char> old_resp(size);
+    std::vector<char> new_resp(size);
+    old_ns[i] = time_(collectStrncat_, received, old_resp);
+    new_ns[i] = time_(collectReply_, received, new_resp);
+    std::printf(
+      "%-16s %10zu %12.2f %12.1f\n",
+      "strncat",
+      size,
+      old_ns[i],
+      1e3 / old_ns[i]);
+    std::printf(
+      "%-16s %10zu %12.2f %12.1f\n",
+      "reply parser",
+      size,
+      new_ns[i],
+      1e3 / new_ns[i]);
+
+    // Both collect the same start of the body.
+    RB_CHECK(std::strcmp(old_resp.data(), new_resp.data()) == 0);
+    ++i;
+  }
+
+  // strncat() scans the whole string for every byte, so it costs more per
+  // byte the more it keeps. The parser costs the same.
+  RB_CHECK(new_ns[0] < old_ns[0]);
+  RB_CHECK(old_ns[1] > 2 * old_ns[0]);
+  RB_CHECK(new_ns[1] < 2 * new_ns[0]);
+  return rb::test::result();
+}
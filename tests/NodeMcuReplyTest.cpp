@@ -0,0 +1,124 @@
+/// \file NodeMcuReplyTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::NodeMcuReply, replaying what the wifi module sends in
+/// a session of the firmware, in spans of every size the receive ring can hand
+/// out.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "NodeMcuReply.hpp"
+#include "NodeMcuTranscript.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+using Reply = rb::NodeMcuReply;
+
+/// \brief Sizes of the spans to feed, up to the size of the receive ring.
+constexpr std::size_t kSpans[] = {1, 2, 7, 64, 512};
+
+/// \brief Feed bytes to a reply in spans, the way WifiClient::await() does.
+///
+/// \return The number of bytes taken.
+std::size_t
+replay_(Reply& reply, const std::string& bytes, std::size_t span)
+{
+  std::size_t taken = 0;
+  while (taken < bytes.size() && reply.state != Reply::Done) {
+    const std::size_t n = std::min(span, bytes.size() - taken);
+    taken += reply.feed(bytes.data() + taken, n);
+  }
+  return taken;
+}
+
+/// \brief Check that a reply takes all of a transcript, and collects an
+/// output.
+void
+checkCommand_(const char* transcript, const char* output, std::size_t span)
+{
+  const std::string bytes = transcript;
+  char              resp[128];
+  Reply             reply(resp, sizeof(resp), Reply::Echo);
+  RB_CHECK_EQ(replay_(reply, bytes, span), bytes.size());
+  RB_CHECK(reply.state == Reply::Done);
+  RB_CHECK(std::strcmp(resp, output) == 0);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  const std::string body     = rb::test::weatherBody();
+  const std::string response = rb::test::weatherResponse(body);
+  const std::string received = rb::test::receiveTranscript(response);
+  RB_CHECK(received.size() > 8 * rb::test::kSegmentSize);
+
+  // The body as the receive handler prints it, with a line break after each
+  // segment, up to the brace that closes it.
+  std::string printed = received.substr(received.find('{'));
+  printed.resize(printed.rfind('}') + 1);
+
+  for (std::size_t span : kSpans) {
+    // The banner after a reset ends at the first prompt.
+    const std::string boot = rb::test::kBootTranscript;
+    Reply             booted(nullptr, 0, Reply::LineStart);
+    RB_CHECK_EQ(replay_(booted, boot, span), boot.size());
+    RB_CHECK(booted.state == Reply::Done);
+
+    checkCommand_(rb::test::kGetIpTranscript, rb::test::kGetIpOutput, span);
+    checkCommand_(rb::test::kArrowTranscript, ">3", span);
+    checkCommand_(rb::test::kScanCommandTranscript, "", span);
+
+    // What comes after the prompt is left for the next reply.
+    const std::string stray = rb::test::kStrayTranscript;
+    Reply             prompt(nullptr, 0, Reply::Echo);
+    RB_CHECK_EQ(replay_(prompt, stray, span), rb::test::kStrayReplyLength);
+
+    // The scan ends at the marker, whether the list fits, is cut short, or is
+    // not kept at all.
+    const std::string scan = rb::test::kScanTranscript;
+    for (int size : {128, 12, 0}) {
+      char  list[128];
+      Reply marked(size ? list : nullptr, size, Reply::LineStart, "--rb-end--");
+      RB_CHECK_EQ(replay_(marked, scan, span), scan.size());
+      RB_CHECK(marked.state == Reply::Done);
+      if (size)
+        RB_CHECK(std::strncmp(list, rb::test::kScanOutput, size - 1) == 0);
+    }
+
+    // A line that only starts with the marker does not end the reply.
+    Reply longer(nullptr, 0, Reply::LineStart, "--rb-end");
+    replay_(longer, scan, span);
+    RB_CHECK(longer.state != Reply::Done);
+
+    // The response is taken up to the brace that closes it. A buffer the size
+    // of the firmware's keeps its start, and a large one all of it.
+    for (std::size_t size : {std::size_t(2048), printed.size() + 1}) {
+      std::vector<char> resp(size);
+      Reply json(resp.data(), size, Reply::LineStart, nullptr, true);
+      RB_CHECK_EQ(
+        replay_(json, received + "> ", span), received.rfind('}') + 1);
+      RB_CHECK(json.state == Reply::Done);
+      RB_CHECK_EQ(json.length, std::min(size - 1, printed.size()));
+      RB_CHECK(printed.compare(0, json.length, resp.data()) == 0);
+    }
+  }
+
+  // The fields the firmware looks for are in the part that fits.
+  const std::string kept = printed.substr(0, 2047);
+  for (const char* field :
+       {"\"humidity\"", "\"daily_chance_of_rain\"", "\"temp_f\"",
+        "\"wind_mph\"", "\"text\""})
+    RB_CHECK(kept.find(field) != std::string::npos);
+  return rb::test::result();
+}
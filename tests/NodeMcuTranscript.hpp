@@ -0,0 +1,207 @@
+/// \file NodeMcuTranscript.hpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief What the wifi module sends back over the link in a session of the
+/// firmware, to replay through the reply parser.
+///
+/// \details Modeled on a NodeMCU 3.0 session at 230400 baud: the REPL echoes
+/// each line as typed, with "\r\n", and prints output with "\n". The response
+/// of weatherapi.com arrives in TCP segments, each printed by the receive
+/// handler of the socket with its own line break after it.
+
+#ifndef RB_TESTS_NODEMCU_TRANSCRIPT_HPP
+#define RB_TESTS_NODEMCU_TRANSCRIPT_HPP
+
+#ifndef __cplusplus
+#error "NodeMcuTranscript.hpp is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdio>
+#include <string>
+
+// ======================= Public Interface ==========================
+
+namespace rb {
+namespace test {
+
+/// \brief Banner of the module after a reset, up to the first prompt.
+constexpr char kBootTranscript[] =
+  "\r\n"
+  " ets Jan  8 2013,rst cause:2, boot mode:(3,6)\r\n"
+  "\r\n"
+  "NodeMCU 3.0.0.0 built with Docker provided by frightanic.com\n"
+  "\tbranch: release\n"
+  "\tcommit: d4ae3c364bd8ae3ded8b77d35745b7f07879f5f9\n"
+  "\tSSL: false\n"
+  "\tBuild type: float\n"
+  "\tLFS: 0x0 bytes total capacity\n"
+  "\tmodules: file,gpio,net,node,tmr,uart,wifi\n"
+  " build 2021-07-25 15:40 powered by Lua 5.1.4 on SDK 3.0.1-dev(fce080e)\n"
+  "cannot open init.lua\n"
+  "> ";
+
+/// \brief print(wifi.sta.getip()) once connected.
+constexpr char kGetIpTranscript[] =
+  "print(wifi.sta.getip())\r\n"
+  "192.168.1.42\t255.255.255.0\t192.168.1.1\n"
+  "> ";
+
+/// \brief Output of getip(), as collected.
+constexpr char kGetIpOutput[] = "192.168.1.42\t255.255.255.0\t192.168.1.1";
+
+/// \brief A line that prints nothing, with the output of a callback, which
+/// belongs to no command, right after the prompt.
+constexpr char kStrayTranscript[] =
+  "skw=skq skr=1 if skup then sk:send(skq) else sk:connect(80,skh) end\r\n"
+  "> HTTP/1.1 200 OK\n";
+
+/// \brief Bytes of kStrayTranscript up to the end of the prompt.
+constexpr std::size_t kStrayReplyLength =
+  sizeof(kStrayTranscript) - sizeof("HTTP/1.1 200 OK\n");
+
+/// \brief Output that starts with a '>', which is not the prompt.
+constexpr char kArrowTranscript[] = "print(\">3\")\r\n"
+                                    ">3\n"
+                                    "> ";
+
+/// \brief The scan of access points: the prompt comes back at once, and the
+/// callback prints the list and the end marker later.
+constexpr char kScanCommandTranscript[] =
+  "wifi.sta.getap(function(t) for k in pairs(t) do print(k) end "
+  "print(\"--rb-end--\") end)\r\n"
+  "> ";
+constexpr char kScanTranscript[] = "GTother\n"
+                                   "GTwifi\n"
+                                   "eduroam\n"
+                                   "HOME-5A2C\n"
+                                   "--rb-end--\n";
+
+/// \brief Output of the scan, as collected.
+constexpr char kScanOutput[] = "GTother\nGTwifi\neduroam\nHOME-5A2C";
+
+/// \brief Largest TCP segment the module receives.
+constexpr std::size_t kSegmentSize = 1460;
+
+/// \brief Get the body of the forecast response of weatherapi.com.
+inline std::string
+weatherBody()
+{
+  std::string body =
+    "{\"location\":{\"name\":\"Atlanta\",\"region\":\"Georgia\",\"country\":"
+    "\"United States of America\",\"lat\":33.75,\"lon\":-84.39,\"tz_id\":"
+    "\"America/New_York\",\"localtime_epoch\":1682452800,\"localtime\":"
+    "\"2023-04-25 16:00\"},\"current\":{\"last_updated_epoch\":1682452800,"
+    "\"last_updated\":\"2023-04-25 16:00\",\"temp_c\":22.2,\"temp_f\":72.0,"
+    "\"is_day\":1,\"condition\":{\"text\":\"Partly cloudy\",\"icon\":"
+    "\"//cdn.weatherapi.com/weather/64x64/day/116.png\",\"code\":1003},"
+    "\"wind_mph\":9.4,\"wind_kph\":15.1,\"wind_degree\":300,\"wind_dir\":"
+    "\"WNW\",\"pressure_mb\":1014.0,\"pressure_in\":29.94,\"precip_mm\":0.0,"
+    "\"precip_in\":0.0,\"humidity\":41,\"cloud\":50,\"feelslike_c\":24.4,"
+    "\"feelslike_f\":75.9,\"vis_km\":16.0,\"vis_miles\":9.0,\"uv\":6.0,"
+    "\"gust_mph\":11.2,\"gust_kph\":18.0},\"forecast\":{\"forecastday\":[{"
+    "\"date\":\"2023-04-25\",\"date_epoch\":1682380800,\"day\":{"
+    "\"maxtemp_c\":23.4,\"maxtemp_f\":74.1,\"mintemp_c\":11.8,\"mintemp_f\":"
+    "53.2,\"avgtemp_c\":17.4,\"avgtemp_f\":63.3,\"maxwind_mph\":10.5,"
+    "\"maxwind_kph\":16.9,\"totalprecip_mm\":0.0,\"totalprecip_in\":0.0,"
+    "\"totalsnow_cm\":0.0,\"avgvis_km\":10.0,\"avgvis_miles\":6.0,"
+    "\"avghumidity\":56.0,\"daily_will_it_rain\":0,\"daily_chance_of_rain\":"
+    "12,\"daily_will_it_snow\":0,\"daily_chance_of_snow\":0,\"condition\":{"
+    "\"text\":\"Sunny\",\"icon\":"
+    "\"//cdn.weatherapi.com/weather/64x64/day/113.png\",\"code\":1000},"
+    "\"uv\":6.0},\"astro\":{\"sunrise\":\"06:55 AM\",\"sunset\":\"08:09 PM\","
+    "\"moonrise\":\"09:51 AM\",\"moonset\":\"12:36 AM\",\"moon_phase\":"
+    "\"Waxing Crescent\",\"moon_illumination\":\"24\",\"is_moon_up\":1,"
+    "\"is_sun_up\":0},\"hour\":[";
+
+  // The hourly forecast, which makes up most of the response.
+  for (int h = 0; h < 24; ++h) {
+    char hour[1024];
+    std::snprintf(
+      hour,
+      sizeof(hour),
+      "%s{\"time_epoch\":%d,\"time\":\"2023-04-25 %02d:00\",\"temp_c\":%.1f,"
+      "\"temp_f\":%.1f,\"is_day\":%d,\"condition\":{\"text\":\"%s\",\"icon\":"
+      "\"//cdn.weatherapi.com/weather/64x64/%s/%d.png\",\"code\":%d},"
+      "\"wind_mph\":%.1f,\"wind_kph\":%.1f,\"wind_degree\":%d,\"wind_dir\":"
+      "\"WNW\",\"pressure_mb\":1014.0,\"pressure_in\":29.95,\"precip_mm\":0.0,"
+      "\"precip_in\":0.0,\"humidity\":%d,\"cloud\":%d,\"feelslike_c\":%.1f,"
+      "\"feelslike_f\":%.1f,\"windchill_c\":%.1f,\"windchill_f\":%.1f,"
+      "\"heatindex_c\":%.1f,\"heatindex_f\":%.1f,\"dewpoint_c\":6.3,"
+      "\"dewpoint_f\":43.3,\"will_it_rain\":0,\"chance_of_rain\":%d,"
+      "\"will_it_snow\":0,\"chance_of_snow\":0,\"vis_km\":10.0,"
+      "\"vis_miles\":6.0,\"gust_mph\":%.1f,\"gust_kph\":%.1f,\"uv\":%.1f}",
+      h ? "," : "",
+      1682380800 + h * 3600,
+      h,
+      12.0 + h % 12,
+      53.6 + (h % 12) * 1.8,
+      h >= 7 && h < 20,
+      h % 5 ? "Clear" : "Partly cloudy",
+      h >= 7 && h < 20 ? "day" : "night",
+      h % 5 ? 113 : 116,
+      h % 5 ? 1000 : 1003,
+      4.0 + h % 7,
+      6.4 + (h % 7) * 1.6,
+      280 + h,
+      80 - h * 2,
+      h % 5 ? 0 : 40,
+      11.5 + h % 12,
+      52.7 + (h % 12) * 1.8,
+      11.5 + h % 12,
+      52.7 + (h % 12) * 1.8,
+      12.0 + h % 12,
+      53.6 + (h % 12) * 1.8,
+      h % 4 * 3,
+      6.0 + h % 9,
+      9.7 + (h % 9) * 1.6,
+      h >= 7 && h < 20 ? 5.0 : 1.0);
+    body += hour;
+  }
+  body += "]}]}}";
+  return body;
+}
+
+/// \brief Get the HTTP response carrying a body.
+inline std::string
+weatherResponse(const std::string& body)
+{
+  char head[400];
+  std::snprintf(
+    head,
+    sizeof(head),
+    "HTTP/1.1 200 OK\r\n"
+    "Date: Tue, 25 Apr 2023 20:03:14 GMT\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: %zu\r\n"
+    "Connection: keep-alive\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "CDN-PullZone: 93447\r\n"
+    "CDN-Uid: 8fa3a04a-75d9-4707-8056-b7b33c8ac7fe\r\n"
+    "CDN-RequestCountryCode: US\r\n"
+    "Age: 0\r\n"
+    "x-weatherapi-qpm-left: 5000000\r\n"
+    "Cache-Control: public, max-age=180\r\n"
+    "Server: BunnyCDN-IL1-864\r\n"
+    "\r\n",
+    body.size());
+  return head + body;
+}
+
+/// \brief Get what the receive handler prints for a response: each segment,
+/// with a line break after it.
+inline std::string
+receiveTranscript(const std::string& response)
+{
+  std::string out;
+  for (std::size_t i = 0; i < response.size(); i += kSegmentSize)
+    out += response.substr(i, kSegmentSize) + "\n";
+  return out;
+}
+
+} // namespace test
+} // namespace rb
+
+// ===================== Detail Implementation =======================
+
+#endif // RB_TESTS_NODEMCU_TRANSCRIPT_HPP
@@ -0,0 +1,601 @@
+/// \file PlayerSim.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Real-time simulator of the MusicPlayer pipeline, from the card to
+/// the DAC, for measuring underruns without a board.
+///
+/// \details The simulation runs in CPU cycles of simulated time. Three
+/// agents take turns in it:
+///
+/// - The DAC plays the bank ring at the sample rate, each bank at the length
+///   it was mixed at, and replays a stale bank when it catches up with the
+///   refills.
+/// - The reader thread serves the voices round robin, reading their files into
+///   their stream rings in chunks, each read taking a latency drawn from a
+///   model of the card.
+/// - The audio thread mixes banks while the ring has room, decoding the stream
+///   rings and mixing the voices with the code the board runs: SpscRing,
+///   SegmentReader.hpp, Mixer.hpp, BankRing.hpp and BankAdapter.hpp. A mix
+///   takes simulated time from a per-sample cost model.
+///
+/// The sizes are those of mbed_app.json, from PlayerConfig.hpp. Each scenario
+/// reports bank underruns, voice underruns and late refills, the refill slack
+/// (how long before the DAC gets to a bank it is mixed), the bank length the
+/// adaptation settles on, and the throughput asked of the card.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "AdpcmVector.hpp"
+#include "AudioFormat.hpp"
+#include "BankAdapter.hpp"
+#include "BankRing.hpp"
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "Mixer.hpp"
+#include "PlayerConfig.hpp"
+#include "SegmentReader.hpp"
+#include "SpscRing.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+using rb::player::kBankCount;
+using rb::player::kBankSize;
+using rb::player::kMinBankSize;
+using rb::player::kMixChunk;
+using rb::player::kStreamReadSize;
+using rb::player::kStreamRingSize;
+using rb::player::kVoiceChunk;
+
+/// \brief CPU cycles per second.
+constexpr std::int64_t kClock = 96000000;
+
+/// \brief Sample rate of the files and the mix.
+constexpr int kRate = rb::player::kDefaultRate;
+
+/// \brief CPU cycles per sample at the DAC.
+constexpr std::int64_t kSampleCycles = kClock / kRate;
+
+/// \brief Seconds of audio played per scenario.
+constexpr double kSeconds = 120;
+
+/// \brief Cycles from the bank interrupt to the audio thread running.
+constexpr std::int64_t kWakeCycles = 20 * kClock / 1000000;
+
+// clang-format off
+/// \brief Format of a voice's file.
+enum Format_
+{
+  Format_U8    = 0
+, Format_S16   = 1
+, Format_Adpcm = 2
+};
+// clang-format on
+
+/// \brief Estimated Cortex-M3 cycles to decode a sample of each format, and to
+/// resample and mix a sample of a voice, and to saturate a mixed sample. To be
+/// brought in line with the refill times of the board's MusicPlayer stats.
+constexpr std::int64_t kDecodeCycles[] = {6, 6, 40};
+constexpr std::int64_t kVoiceCycles    = 30;
+constexpr std::int64_t kMixDownCycles  = 8;
+
+/// \brief Model of the card: a read takes an access time, then streams at a
+/// fixed rate, and now and then stalls on top, e.g. on internal housekeeping.
+struct Card_
+{
+  const char* name;
+  double      access_us;  // Command to first byte, drawn between 1 and 2x.
+  double      kb_per_ms;  // Transfer rate.
+  double      stall_rate; // Chance of a stall per read.
+  double      stall_min_ms;
+  double      stall_max_ms;
+};
+
+/// \brief SPI at 12.5 MHz, with short rare stalls.
+constexpr Card_ kGoodCard = {"good card", 300, 1.2, 0.002, 2, 10};
+
+/// \brief The same bus, with a card that stalls often and for long.
+constexpr Card_ kSlowCard = {"slow card", 800, 1.0, 0.02, 20, 120};
+
+/// \brief A run of the simulator.
+struct Scenario_
+{
+  const char*          name;
+  std::vector<Format_> voices;
+  Card_                card;
+  bool                 clean; // Expected to play without any gap.
+};
+
+/// \brief Bytes of a file of each format holding some samples.
+std::size_t
+fileSize_(Format_ format, long samples)
+{
+  constexpr long kPerBlock = 1 + 2 * (kAdpcmBlock - rb::ImaAdpcm::kHeaderSize);
+  switch (format) {
+    case Format_U8:
+      return samples;
+
+    case Format_S16:
+      return 2 * samples;
+
+    default:
+      return (samples / kPerBlock + 1) * kAdpcmBlock;
+  }
+}
+
+/// \brief Segment of a whole file of each format.
+rb::Segment
+segmentOf_(Format_ format, std::size_t size)
+{
+  const long bytes = static_cast<long>(size);
+  switch (format) {
+    case Format_U8:
+      return {rb::Segment::U8Pcm, kRate, 8, 1, 1, bytes, -1};
+
+    case Format_S16:
+      return {rb::Segment::Wav, kRate, 16, 1, 2, bytes, -1};
+
+    default:
+      return {rb::Segment::Adpcm, kRate, 4, 1, kAdpcmBlock, bytes, -1};
+  }
+}
+
+/// \brief A voice: its file, its stream ring, and its decoder and mixer
+/// state.
+struct Voice_
+{
+  Format_                    format;
+  std::vector<std::uint8_t>  file;
+  std::size_t                unread; // Bytes of the file not yet read.
+  std::vector<std::uint8_t>  storage;
+  rb::SpscRing<std::uint8_t> stream;
+  rb::SegmentReader          reader;
+  rb::player::Sample         in[kVoiceChunk];
+  int                        in_pos   = 0;
+  int                        in_count = 0;
+  rb::VoiceMixer             mixer;
+  rb::Fade                   fade;
+  bool                       ended     = false;
+  long                       underruns = 0; // Banks it was starved in.
+
+  Voice_(Format_ format_, long samples, std::size_t ring) :
+      format(format_),
+      file(fileSize_(format_, samples)),
+      unread(file.size()),
+      storage(ring),
+      stream(storage.data(), ring),
+      reader(&stream, nullptr)
+  {
+    reader.start(segmentOf_(format, file.size()));
+    if (format == Format_Adpcm) {
+      for (std::size_t i = 0; i < file.size(); ++i)
+        file[i] = kAdpcmCoded[i % sizeof(kAdpcmCoded)];
+    } else {
+      for (std::size_t i = 0; i < file.size(); ++i)
+        file[i] = static_cast<std::uint8_t>(i * 37 + (i >> 7));
+    }
+  }
+
+  /// \brief Check if all of the file has been decoded.
+  bool drained() const { return reader.done() && in_pos == in_count; }
+};
+
+/// \brief Decode the next chunk of a voice from its stream ring.
+///
+/// \param cost Incremented by the cycles taken.
+///
+/// \return The number of samples decoded, 0 if the stream ring is short.
+int
+decode_(Voice_& v, std::int64_t& cost)
+{
+  const int n = v.reader.read(v.in, kVoiceChunk);
+  cost += n * kDecodeCycles[v.format];
+  v.in_pos   = 0;
+  v.in_count = n;
+  return n;
+}
+
+// clang-format off
+/// \brief Outcome of taking samples from a voice.
+enum Fetch_
+{
+  Fetch_Ok      = 0
+, Fetch_Starved = 1
+, Fetch_Ended   = 2
+};
+// clang-format on
+
+/// \brief Take the next sample of a voice, signed.
+Fetch_
+nextSample_(Voice_& v, int& sample, std::int64_t& cost)
+{
+  if (v.in_pos == v.in_count && !decode_(v, cost))
+    return v.drained() ? Fetch_Ended : Fetch_Starved;
+  sample = static_cast<int>(v.in[v.in_pos++]) - 0x8000;
+  return Fetch_Ok;
+}
+
+/// \brief Outcome of a scenario.
+struct Result_
+{
+  long   banks;
+  long   underruns;       // Refills that found the DAC caught up.
+  long   voice_underruns; // Banks a voice was starved in, all voices.
+  long   late_refills;    // Banks finished after the DAC got to them.
+  double slack_min_ms;
+  double slack_mean_ms;
+  int    bank_samples; // As last adapted.
+  double read_kb_s;    // Card throughput asked for.
+  double card_busy;    // Fraction of the time the card was reading.
+  double first_ms;     // Time to first sound.
+  double sim_speed;    // Simulated seconds per second.
+};
+
+/// \brief The simulator of one scenario.
+class Sim_
+{
+ public:
+  explicit Sim_(const Scenario_& scenario, unsigned int seed) :
+      _card(scenario.card),
+      _rng(seed),
+      _adapter(kBankCount, kMinBankSize, kBankSize)
+  {
+    const long  samples = static_cast<long>((kSeconds + 1) * kRate);
+    std::size_t ring    = kStreamRingSize;
+    while (ring * scenario.voices.size() > kStreamRingSize)
+      ring /= 2;
+    for (Format_ format : scenario.voices)
+      _voices.emplace_back(new Voice_(format, samples, ring));
+  }
+
+  Result_ run();
+
+ private:
+  /// \brief Start a card read if a voice has room for one.
+  void startRead_();
+
+  /// \brief Land a finished card read in its stream ring.
+  void finishRead_();
+
+  /// \brief Mix a bank, the way mixBank_ does.
+  ///
+  /// \param running Whether the DAC is playing the banks already. A voice
+  /// that is short is waited for until the bank is due, or for as long as it
+  /// takes before the DAC starts.
+  ///
+  /// \param starved Set if a voice was starved in the bank.
+  ///
+  /// \return The cycles taken, besides the waits.
+  std::int64_t mixBank_(int len, bool running, bool& starved);
+
+  /// \brief Start a refill on the audio thread, the way the loop of
+  /// runSession_ does.
+  void startRefill_();
+
+  /// \brief Finish the refill in flight.
+  void finishRefill_();
+
+  /// \brief Get the time the DAC starts on a bank not yet played.
+  std::int64_t startOf_(unsigned int bank) const;
+
+  /// \brief Move on to the next event.
+  void step_();
+
+  Card_                                _card;
+  std::mt19937                         _rng;
+  std::vector<std::unique_ptr<Voice_>> _voices;
+  rb::BankAdapter                      _adapter;
+  std::int64_t                         _now = 0;
+
+  // The bank being played is played until _dac_end.
+  rb::BankRing _ring{kBankCount};
+  int          _bank_len[kBankCount];
+  std::int64_t _dac_end = -1;
+
+  // The audio thread is mixing until _audio_until, or asleep until a bank
+  // interrupt if _asleep.
+  std::int64_t _audio_until    = -1;
+  std::int64_t _refill_start   = 0;
+  std::int64_t _refill_cost    = 0;
+  bool         _refill_starved = false;
+  bool         _asleep         = false;
+
+  // The reader thread is waiting for the card until _read_until.
+  std::int64_t _read_until = -1;
+  Voice_*      _reading    = nullptr;
+  std::size_t  _read_n     = 0;
+  std::size_t  _next_voice = 0;
+
+  long         _underruns    = 0;
+  long         _late_refills = 0;
+  long         _banks        = 0;
+  std::int64_t _slack_min    = INT64_MAX;
+  double       _slack_sum    = 0;
+  long         _refills      = 0;
+  std::int64_t _read_bytes   = 0;
+  std::int64_t _card_busy    = 0;
+};
+
+void
+Sim_::startRead_()
+{
+  if (_reading)
+    return;
+  for (std::size_t i = 0; i < _voices.size(); ++i) {
+    Voice_& v = *_voices[(_next_voice + i) % _voices.size()];
+    // Only read in large chunks, unless the file is almost done.
+    if (!v.unread || v.stream.space() < std::min(kStreamReadSize, v.unread))
+      continue;
+
+    std::uint8_t* span;
+    _read_n = std::min({v.stream.writeSpan(span), kStreamReadSize, v.unread});
+    _reading    = &v;
+    _next_voice = (_next_voice + i + 1) % _voices.size();
+
+    std::uniform_real_distribution<double> unit(0, 1);
+    double us = _card.access_us * (1 + unit(_rng)) +
+                _read_n / 1024.0 / _card.kb_per_ms * 1000;
+    if (unit(_rng) < _card.stall_rate)
+      us += 1000 * (_card.stall_min_ms +
+                    (_card.stall_max_ms - _card.stall_min_ms) * unit(_rng));
+    const std::int64_t cycles = static_cast<std::int64_t>(us * kClock / 1e6);
+    _read_until               = _now + cycles;
+    _card_busy += cycles;
+    return;
+  }
+}
+
+void
+Sim_::finishRead_()
+{
+  Voice_&           v    = *_reading;
+  const std::size_t done = v.file.size() - v.unread;
+  v.stream.write(v.file.data() + done, _read_n);
+  v.unread -= _read_n;
+  _read_bytes += _read_n;
+  _reading    = nullptr;
+  _read_until = -1;
+}
+
+std::int64_t
+Sim_::mixBank_(int len, bool running, bool& starved)
+{
+  std::int64_t       cost = len * kMixDownCycles;
+  std::int32_t       acc[kMixChunk];
+  rb::player::Sample out[kMixChunk];
+
+  std::vector<bool> silent(_voices.size(), false);
+  for (int done = 0; done < len; done += kMixChunk) {
+    const int n = std::min(kMixChunk, len - done);
+    std::fill(acc, acc + n, 0);
+    for (std::size_t i = 0; i < _voices.size(); ++i) {
+      Voice_& v = *_voices[i];
+      if (v.ended || silent[i])
+        continue;
+      Fetch_ fetch = Fetch_Ok;
+      cost += n * kVoiceCycles;
+      v.mixer.mix(v.fade, rb::mixGain(0, 0), acc, n, [&](int& s) {
+        while ((fetch = nextSample_(v, s, cost)) == Fetch_Starved &&
+               (!running || !_ring.due()))
+          step_();
+        return fetch == Fetch_Ok;
+      });
+      if (fetch == Fetch_Starved) {
+        silent[i] = true;
+        starved   = true;
+        ++v.underruns;
+      } else if (fetch == Fetch_Ended) {
+        v.ended = true;
+      }
+    }
+    rb::mixDown(acc, out, n);
+    rb::test::keep(out);
+  }
+  return cost;
+}
+
+void
+Sim_::startRefill_()
+{
+  // On an underrun the DMA is replaying a stale bank.
+  if (_ring.resync())
+    ++_underruns;
+  const int len = _adapter.length();
+
+  _refill_start   = _now;
+  _refill_starved = false;
+  _refill_cost    = mixBank_(len, true, _refill_starved);
+  _audio_until    = _now + _refill_cost;
+}
+
+void
+Sim_::finishRefill_()
+{
+  // Timed from its start, waits for the reader included, as on the board.
+  _adapter.record(
+    static_cast<std::uint32_t>(_now - _refill_start),
+    kSampleCycles,
+    _refill_starved);
+  _bank_len[_ring.slot(_ring.produced())] = _adapter.length();
+  if (_ring.late()) {
+    ++_late_refills;
+  } else {
+    const std::int64_t slack = startOf_(_ring.produced()) - _now;
+    _slack_min               = std::min(_slack_min, slack);
+    _slack_sum += slack;
+    ++_refills;
+  }
+  _ring.produce();
+  _audio_until = -1;
+}
+
+std::int64_t
+Sim_::startOf_(unsigned int bank) const
+{
+  std::int64_t t = _dac_end;
+  for (unsigned int b = _ring.consumed() + 1; b != bank; ++b)
+    t += _bank_len[_ring.slot(b)] * kSampleCycles;
+  return t;
+}
+
+void
+Sim_::step_()
+{
+  std::int64_t next = INT64_MAX;
+  for (std::int64_t t : {_dac_end, _audio_until, _read_until})
+    if (t >= 0)
+      next = std::min(next, t);
+  _now = next;
+
+  if (_now == _read_until)
+    finishRead_();
+  if (_now == _dac_end) {
+    // The channel goes on to the next bank, stale or not, and the interrupt
+    // wakes the audio thread.
+    _ring.consume();
+    ++_banks;
+    _dac_end += _bank_len[_ring.slot(_ring.consumed())] * kSampleCycles;
+    if (_asleep) {
+      _asleep      = false;
+      _refill_cost = 0;
+      _audio_until = _now + kWakeCycles;
+    }
+  }
+  if (_now == _audio_until) {
+    if (_refill_cost)
+      finishRefill_();
+    _audio_until = -1;
+    if (!_ring.full())
+      startRefill_();
+    else
+      _asleep = true;
+  }
+  startRead_();
+}
+
+Result_
+Sim_::run()
+{
+  const double wall_start = rb::test::now();
+
+  // Voices wait for their first samples before the banks start to play, then
+  // the whole ring is mixed.
+  startRead_();
+  std::int64_t cost = 0;
+  for (auto& v : _voices) {
+    int first = 0;
+    while (nextSample_(*v, first, cost) == Fetch_Starved)
+      step_();
+    v->mixer.prime(first);
+    v->mixer.setRates(kRate, kRate);
+  }
+  while (!_ring.full()) {
+    const int len = _adapter.length();
+    bool starved;
+    _now += mixBank_(len, false, starved);
+    _bank_len[_ring.slot(_ring.produced())] = len;
+    _ring.produce();
+  }
+  const std::int64_t first = _now;
+
+  _dac_end     = _now + _bank_len[0] * kSampleCycles;
+  _asleep      = true;
+  _audio_until = -1;
+  while (_now < first + static_cast<std::int64_t>(kSeconds * kClock))
+    step_();
+
+  const double seconds = static_cast<double>(_now - first) / kClock;
+  Result_      r       = {};
+  r.banks              = _banks;
+  r.underruns          = _underruns;
+  for (auto& v : _voices)
+    r.voice_underruns += v->underruns;
+  r.late_refills  = _late_refills;
+  r.slack_min_ms  = _refills ? 1e3 * _slack_min / kClock : 0;
+  r.slack_mean_ms = _refills ? 1e3 * _slack_sum / _refills / kClock : 0;
+  r.bank_samples  = _adapter.length();
+  r.read_kb_s     = _read_bytes / 1024.0 / seconds;
+  r.card_busy     = static_cast<double>(_card_busy) / (_now - first);
+  r.first_ms      = 1e3 * first / kClock;
+  r.sim_speed     = seconds / (rb::test::now() - wall_start);
+  return r;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  const Scenario_ scenarios[] = {
+    {"music", {Format_S16}, kGoodCard, true},
+    {"speech over music",
+     {Format_S16, Format_Adpcm, Format_Adpcm},
+     kGoodCard,
+     true},
+    {"four voices",
+     {Format_S16, Format_U8, Format_Adpcm, Format_Adpcm},
+     kGoodCard,
+     true},
+    {"music, slow card", {Format_S16, Format_S16}, kSlowCard, false},
+  };
+
+  std::printf(
+    "%-20s %-10s %6s %6s %6s %6s %9s %9s %5s %7s %5s %7s %7s\n",
+    "scenario",
+    "card",
+    "banks",
+    "under",
+    "voice",
+    "late",
+    "slack min",
+    "slack avg",
+    "bank",
+    "KB/s",
+    "busy",
+    "first",
+    "speed");
+  for (const Scenario_& scenario : scenarios) {
+    Sim_          sim(scenario, 1);
+    const Result_ r = sim.run();
+    std::printf(
+      "%-20s %-10s %6ld %6ld %6ld %6ld %7.2fms %7.2fms %5d %7.1f %4.0f%% "
+      "%5.1fms %6.0fx\n",
+      scenario.name,
+      scenario.card.name,
+      r.banks,
+      r.underruns,
+      r.voice_underruns,
+      r.late_refills,
+      r.slack_min_ms,
+      r.slack_mean_ms,
+      r.bank_samples,
+      r.read_kb_s,
+      100 * r.card_busy,
+      r.first_ms,
+      r.sim_speed);
+
+    // The mix only waits on the card until a bank is due, so the ring itself
+    // never underruns, however slow the card. A slow card only costs the
+    // voices gaps.
+    RB_CHECK_EQ(r.underruns, 0);
+    RB_CHECK_EQ(r.late_refills, 0);
+    if (scenario.clean) {
+      RB_CHECK_EQ(r.voice_underruns, 0);
+    } else {
+      // The gaps grow the banks, until the ring covers all but the longest
+      // stalls of the card, and the voices miss less than a bank in a hundred.
+      RB_CHECK(r.bank_samples > kMinBankSize);
+      RB_CHECK(r.voice_underruns * 100 < r.banks);
+    }
+  }
+  return rb::test::result();
+}
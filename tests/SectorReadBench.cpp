@@ -0,0 +1,206 @@
+/// \file SectorReadBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of the read paths of the sample data of a file, against a
+/// file-backed block device: through a stdio buffer, through the file handle,
+/// and in whole sectors at sector offsets.
+///
+/// \details The file system is modeled on FatFs's f_read: partial sectors are
+/// read into the file's sector buffer and copied out of it, and whole sectors
+/// are read in one multi-block command straight into the destination. The
+/// sample data starts after a WAV header, off a sector boundary, and is read
+/// in stream-read-sized requests, the way the reader thread does.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "FileBlockDevice.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+constexpr std::size_t kSector = rb::test::FileBlockDevice::kSectorSize;
+
+/// \brief Size of the file.
+constexpr std::size_t kFileSize = 4 << 20;
+
+/// \brief Offset of the sample data, after a WAV header.
+constexpr std::size_t kDataStart = 44;
+
+/// \brief Bytes per request, MUSIC_PLAYER_STREAM_READ_SIZE.
+constexpr std::size_t kReadSize = 1024;
+
+/// \brief Size of a stdio buffer, BUFSIZ of newlib.
+constexpr std::size_t kStdioBuffer = 1024;
+
+/// \brief Runs of each path. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief A file laid out in consecutive sectors from the start of the
+/// device, read the way FatFs reads it.
+class FatFile_
+{
+ public:
+  explicit FatFile_(mbed::BlockDevice& device) : _device(device) {}
+
+  /// \brief Read from the file.
+  void read(std::size_t pos, std::uint8_t* out, std::size_t n)
+  {
+    while (n > 0) {
+      const std::size_t sector = pos / kSector;
+      const std::size_t offset = pos % kSector;
+      std::size_t       done;
+      if (offset == 0 && n >= kSector) {
+        done = n / kSector * kSector;
+        _device.read(out, sector * kSector, done);
+      } else {
+        if (sector != _buffered) {
+          _device.read(_buffer, sector * kSector, kSector);
+          _buffered = sector;
+        }
+        done = std::min(kSector - offset, n);
+        std::memcpy(out, _buffer + offset, done);
+      }
+      out += done;
+      pos += done;
+      n -= done;
+    }
+  }
+
+ private:
+  mbed::BlockDevice& _device;
+  std::uint8_t       _buffer[kSector];
+  std::size_t        _buffered = SIZE_MAX; // Sector in the buffer.
+};
+
+/// \brief Read the sample data through a stdio buffer, the way fread() does:
+/// the buffer is refilled from the file position, and each request copied
+/// out of it.
+void
+readStdio_(FatFile_& file, std::uint8_t* out)
+{
+  std::uint8_t buffer[kStdioBuffer];
+  std::size_t  pos   = kDataStart; // File position of the buffer.
+  std::size_t  at    = 0;          // Position in the buffer.
+  std::size_t  valid = 0;          // Bytes in the buffer.
+  for (std::size_t done = kDataStart; done < kFileSize;) {
+    std::size_t want = std::min(kReadSize, kFileSize - done);
+    while (want > 0) {
+      if (at == valid) {
+        pos += valid;
+        valid = std::min(kStdioBuffer, kFileSize - pos);
+        file.read(pos, buffer, valid);
+        at = 0;
+      }
+      const std::size_t n = std::min(want, valid - at);
+      std::memcpy(out + done, buffer + at, n);
+      at += n;
+      done += n;
+      want -= n;
+    }
+  }
+}
+
+/// \brief Read the sample data through the file handle, skipping stdio.
+void
+readHandle_(FatFile_& file, std::uint8_t* out)
+{
+  for (std::size_t pos = kDataStart; pos < kFileSize; pos += kReadSize)
+    file.read(pos, out + pos, std::min(kReadSize, kFileSize - pos));
+}
+
+/// \brief Read the sample data through the file handle, each request ending
+/// on a sector boundary, as streamChunk_ does. After the first, every request
+/// is whole sectors.
+void
+readSectors_(FatFile_& file, std::uint8_t* out)
+{
+  for (std::size_t pos = kDataStart; pos < kFileSize;) {
+    std::size_t n = std::min(kReadSize, kFileSize - pos);
+    if (n > kSector)
+      n -= (pos + n) % kSector;
+    file.read(pos, out + pos, n);
+    pos += n;
+  }
+}
+
+/// \brief Figures of a path.
+struct Result_
+{
+  double mb_s;        // Host throughput.
+  double commands_kb; // Device commands per KB.
+  double card_kb_s;   // Modeled throughput on the card.
+};
+
+/// \brief Time a path over kRuns runs, and check what it read.
+template<typename F>
+Result_
+time_(
+  F&&                              path,
+  rb::test::FileBlockDevice&       device,
+  const std::vector<std::uint8_t>& data)
+{
+  std::vector<std::uint8_t> out(kFileSize);
+  double                    best = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    FatFile_ file(device);
+    device.resetStats();
+    const double start = rb::test::now();
+    path(file, out.data());
+    best = std::min(best, rb::test::now() - start);
+  }
+  RB_CHECK(std::equal(
+    out.begin() + kDataStart, out.end(), data.begin() + kDataStart));
+
+  const double                            bytes = kFileSize - kDataStart;
+  const rb::test::FileBlockDevice::Stats& stats = device.stats();
+  return {
+    bytes / best / (1 << 20),
+    stats.commands / (bytes / 1024),
+    bytes / 1024 / (stats.card_us / 1e6)};
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::vector<std::uint8_t> data(kFileSize);
+  for (std::size_t i = 0; i < kFileSize; ++i)
+    data[i] = static_cast<std::uint8_t>(i * 131 + (i >> 9));
+  rb::test::FileBlockDevice device(data.data(), data.size());
+
+  const Result_ stdio   = time_(readStdio_, device, data);
+  const Result_ handle  = time_(readHandle_, device, data);
+  const Result_ sectors = time_(readSectors_, device, data);
+
+  std::printf(
+    "%-16s %12s %14s %14s\n", "path", "host MB/s", "commands/KB", "card KB/s");
+  for (const auto& [name, r] : {
+         std::make_pair("stdio buffer", stdio),
+         std::make_pair("file handle", handle),
+         std::make_pair("whole sectors", sectors)})
+    std::printf(
+      "%-16s %12.0f %14.2f %14.0f\n",
+      name,
+      r.mb_s,
+      r.commands_kb,
+      r.card_kb_s);
+
+  // Whole sectors take one command per request, where unaligned requests take
+  // two.
+  RB_CHECK(sectors.commands_kb < 1.01);
+  RB_CHECK(handle.commands_kb > 1.99);
+  RB_CHECK(sectors.card_kb_s > handle.card_kb_s);
+  return rb::test::result();
+}
@@ -0,0 +1,130 @@
+/// \file SegmentReaderTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::SegmentReader: decoding out of a stream ring that the
+/// reader thread tops up a little at a time, and out of the clip cache, in
+/// reads of every size the mixer asks for.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "AdpcmVector.hpp"
+#include "AudioFormat.hpp"
+#include "Check.hpp"
+#include "ClipCache.hpp"
+#include "PlayerConfig.hpp"
+#include "SegmentReader.hpp"
+#include "SpscRing.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+using Sample = rb::player::Sample;
+
+/// \brief The test vector as a segment.
+constexpr rb::Segment kAdpcmSegment = {
+  rb::Segment::Adpcm, 24000, 4, 1, kAdpcmBlock, sizeof(kAdpcmCoded), -1};
+
+/// \brief Decode a segment out of a stream ring topped up a few bytes at a
+/// time, in reads of a number of samples.
+std::vector<Sample>
+stream_(const rb::Segment& seg, const std::uint8_t* data, int feed, int count)
+{
+  std::uint8_t               storage[64];
+  rb::SpscRing<std::uint8_t> stream(storage, sizeof(storage));
+  rb::SegmentReader          reader(&stream, nullptr);
+  reader.start(seg);
+
+  std::vector<Sample> out;
+  long                fed = 0;
+  while (!reader.done()) {
+    // The reader thread only hands over so much before the mix catches up.
+    const long n = std::min<long>(
+      {static_cast<long>(feed), seg.size - fed,
+       static_cast<long>(stream.space())});
+    stream.write(data + fed, n);
+    fed += n;
+
+    Sample    buffer[rb::player::kVoiceChunk];
+    const int read_ct = reader.read(buffer, count);
+    if (!RB_CHECK(read_ct >= 0) || (!read_ct && !n && fed == seg.size))
+      break;
+    out.insert(out.end(), buffer, buffer + read_ct);
+  }
+  return out;
+}
+
+/// \brief Check samples against the reference decoding of the test vector.
+void
+checkAdpcm_(const std::vector<Sample>& out)
+{
+  constexpr std::size_t kCount =
+    sizeof(kAdpcmDecoded) / sizeof(kAdpcmDecoded[0]);
+  if (!RB_CHECK_EQ(out.size(), kCount))
+    return;
+  for (std::size_t i = 0; i < kCount; ++i)
+    if (!RB_CHECK_EQ(out[i], rb::dacSample(kAdpcmDecoded[i])))
+      return;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  // ADPCM resumes anywhere in a block, and across a byte cut in two by a read
+  // of an odd number of samples.
+  for (int feed : {1, 3, 17, 64})
+    for (int count : {1, 7, 8, rb::player::kVoiceChunk})
+      checkAdpcm_(stream_(kAdpcmSegment, kAdpcmCoded, feed, count));
+
+  // Only whole frames are taken out of the stream ring.
+  const std::uint8_t stereo[] = {0x00, 0x40, 0x00, 0x40, 0x00, 0xC0, 0, 0};
+  const rb::Segment  wav      = {rb::Segment::Wav, 24000, 16, 2, 4, 8, -1};
+
+  std::uint8_t               storage[16];
+  rb::SpscRing<std::uint8_t> stream(storage, sizeof(storage));
+  rb::SegmentReader          reader(&stream, nullptr);
+  reader.start(wav);
+  Sample buffer[4];
+  stream.write(stereo, 3);
+  RB_CHECK_EQ(reader.read(buffer, 4), 0);
+  stream.write(stereo + 3, 5);
+  RB_CHECK_EQ(reader.read(buffer, 4), 2);
+  RB_CHECK_EQ(buffer[0], rb::dacSample(0x4000));
+  RB_CHECK_EQ(buffer[1], rb::dacSample(-0x2000));
+  RB_CHECK(reader.done());
+
+  // A cached segment is read from its clip, whatever is in the stream ring.
+  std::uint8_t  cache_storage[4 * rb::ClipCache::kBlockSize];
+  rb::ClipCache cache(cache_storage, sizeof(cache_storage));
+  const int     clip = cache.insert("vector", sizeof(kAdpcmCoded));
+  if (!RB_CHECK(clip >= 0))
+    return rb::test::result();
+  std::size_t   offset = 0;
+  std::uint8_t* span;
+  while (std::size_t n = cache.writeSpan(clip, offset, span)) {
+    std::copy(kAdpcmCoded + offset, kAdpcmCoded + offset + n, span);
+    offset += n;
+  }
+  cache.publish(clip);
+
+  rb::Segment cached = kAdpcmSegment;
+  cached.clip        = clip;
+  rb::SegmentReader from_cache(&stream, &cache);
+  from_cache.start(cached);
+  std::vector<Sample> out;
+  while (!from_cache.done()) {
+    const int read_ct = from_cache.read(buffer, 3);
+    if (!RB_CHECK(read_ct > 0))
+      break;
+    out.insert(out.end(), buffer, buffer + read_ct);
+  }
+  checkAdpcm_(out);
+  return rb::test::result();
+}
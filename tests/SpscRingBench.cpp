@@ -0,0 +1,135 @@
+/// \file SpscRingBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of rb::SpscRing, shaped like a stream ring of the
+/// MusicPlayer: the producer writes large reads, and the consumer takes the
+/// small chunks the decoders ask for.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "SpscRing.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Bytes of a stream ring, MUSIC_PLAYER_STREAM_RING_SIZE for one voice.
+constexpr std::size_t kRingSize = 4096;
+
+/// \brief Bytes pushed through per run.
+constexpr std::uint64_t kTotal = 64u << 20;
+
+/// \brief Push kTotal bytes through a ring on one thread, alternating between
+/// the two sides.
+///
+/// \return Seconds taken.
+double
+runSingle_(std::size_t write_size, std::size_t read_size)
+{
+  std::vector<std::uint8_t>  storage(kRingSize);
+  rb::SpscRing<std::uint8_t> ring(storage.data(), kRingSize);
+  std::vector<std::uint8_t>  in(write_size, 1);
+  std::vector<std::uint8_t>  out(read_size);
+
+  std::uint64_t sum   = 0;
+  const double  start = rb::test::now();
+  for (std::uint64_t done = 0; done < kTotal;) {
+    while (ring.space() >= write_size)
+      ring.write(in.data(), write_size);
+    while (ring.size() >= read_size) {
+      ring.read(out.data(), read_size);
+      sum += out[0];
+      done += read_size;
+    }
+  }
+  const double seconds = rb::test::now() - start;
+  rb::test::keep(sum);
+  RB_CHECK_EQ(sum, kTotal / read_size);
+  return seconds;
+}
+
+/// \brief Push kTotal bytes through a ring from one thread to another, the
+/// producer writing in place like the reader thread does.
+///
+/// \return Seconds taken.
+double
+runThreads_(std::size_t write_size, std::size_t read_size)
+{
+  std::vector<std::uint8_t>  storage(kRingSize);
+  rb::SpscRing<std::uint8_t> ring(storage.data(), kRingSize);
+
+  const double start = rb::test::now();
+  std::thread  producer([&] {
+    std::uint8_t value = 0;
+    for (std::uint64_t done = 0; done < kTotal;) {
+      std::uint8_t* span;
+      std::size_t   n = ring.writeSpan(span);
+      n = std::min<std::uint64_t>({n, write_size, kTotal - done});
+      for (std::size_t i = 0; i < n; ++i)
+        span[i] = value++;
+      ring.commit(n);
+      done += n;
+      // A single core host would otherwise spin out the whole time slice.
+      if (!n)
+        std::this_thread::yield();
+    }
+  });
+
+  std::vector<std::uint8_t> out(read_size);
+  std::uint8_t              expect = 0;
+  bool                      ok     = true;
+  for (std::uint64_t done = 0; done < kTotal;) {
+    const std::size_t n = ring.read(out.data(), read_size);
+    for (std::size_t i = 0; i < n; ++i)
+      ok &= out[i] == expect++;
+    done += n;
+    if (!n)
+      std::this_thread::yield();
+  }
+  producer.join();
+  const double seconds = rb::test::now() - start;
+  RB_CHECK(ok);
+  return seconds;
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  std::printf(
+    "%llu MB through a %zu byte ring\n",
+    static_cast<unsigned long long>(kTotal >> 20),
+    kRingSize);
+  std::printf("%-12s %8s %8s %10s\n", "", "write", "read", "MB/s");
+
+  const std::size_t kSizes[][2] = {{1024, 1}, {1024, 32}, {1024, 64}};
+  for (const auto& size : kSizes) {
+    const double s = runSingle_(size[0], size[1]);
+    std::printf(
+      "%-12s %8zu %8zu %10.0f\n",
+      "one thread",
+      size[0],
+      size[1],
+      kTotal / s / 1e6);
+  }
+  for (const auto& size : kSizes) {
+    const double s = runThreads_(size[0], size[1]);
+    std::printf(
+      "%-12s %8zu %8zu %10.0f\n",
+      "two threads",
+      size[0],
+      size[1],
+      kTotal / s / 1e6);
+  }
+  return rb::test::result();
+}
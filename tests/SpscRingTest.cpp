@@ -0,0 +1,159 @@
+/// \file SpscRingTest.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Tests of rb::SpscRing: wraparound of the indices and spans, and a
+/// producer and consumer running on two threads.
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "SpscRing.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Push odd sized chunks through a ring many times over, so that every
+/// offset of the storage is a wrap point at some time, and check the order.
+void
+testWraparound_()
+{
+  std::uint8_t               storage[16];
+  rb::SpscRing<std::uint8_t> ring(storage, sizeof(storage));
+  RB_CHECK_EQ(ring.capacity(), 16);
+  RB_CHECK_EQ(ring.size(), 0);
+  RB_CHECK_EQ(ring.space(), 16);
+
+  std::uint8_t in  = 0;
+  std::uint8_t out = 0;
+  for (int round = 0; round < 1000; ++round) {
+    const int    count = 1 + round % 7;
+    std::uint8_t chunk[8];
+    for (int i = 0; i < count; ++i)
+      chunk[i] = in++;
+    RB_CHECK_EQ(ring.write(chunk, count), count);
+
+    // Drain all but a few, so the data straddles the end of the storage.
+    while (ring.size() > 3) {
+      std::uint8_t c = 0;
+      RB_CHECK_EQ(ring.read(&c, 1), 1);
+      RB_CHECK_EQ(c, out++);
+    }
+  }
+}
+
+/// \brief Check the spans split at the end of the storage, and that a full
+/// ring takes no more.
+void
+testSpans_()
+{
+  int               storage[8];
+  rb::SpscRing<int> ring(storage, 8);
+  const int         data[6] = {0, 1, 2, 3, 4, 5};
+  int               sink[5];
+  int*              wspan;
+  const int*        rspan;
+
+  RB_CHECK_EQ(ring.write(data, 6), 6);
+  RB_CHECK_EQ(ring.read(sink, 5), 5);
+  RB_CHECK_EQ(sink[4], 4);
+
+  // One element at offset 5, and room for 7 from offset 6: 2 before the end
+  // of the storage, then 5 from its start.
+  RB_CHECK_EQ(ring.writeSpan(wspan), 2);
+  RB_CHECK(wspan == storage + 6);
+  wspan[0] = 10;
+  wspan[1] = 11;
+  ring.commit(2);
+  RB_CHECK_EQ(ring.writeSpan(wspan), 5);
+  RB_CHECK(wspan == storage);
+  for (int i = 0; i < 5; ++i)
+    wspan[i] = 12 + i;
+  ring.commit(5);
+  RB_CHECK_EQ(ring.space(), 0);
+  RB_CHECK_EQ(ring.write(data, 1), 0);
+
+  RB_CHECK_EQ(ring.readSpan(rspan), 3);
+  RB_CHECK(rspan == storage + 5);
+  RB_CHECK_EQ(rspan[0], 5);
+  RB_CHECK_EQ(rspan[1], 10);
+  RB_CHECK_EQ(rspan[2], 11);
+  ring.consume(3);
+  RB_CHECK_EQ(ring.readSpan(rspan), 5);
+  RB_CHECK(rspan == storage);
+  RB_CHECK_EQ(rspan[4], 16);
+  ring.consume(5);
+  RB_CHECK_EQ(ring.size(), 0);
+  RB_CHECK_EQ(ring.readSpan(rspan), 0);
+}
+
+/// \brief Stream a counting sequence from one thread to another, in chunk
+/// sizes that keep changing on both sides, and check that it comes through
+/// whole and in order.
+void
+testConcurrent_()
+{
+  constexpr std::uint32_t kCount = 1 << 22;
+
+  std::vector<std::uint32_t>  storage(64);
+  rb::SpscRing<std::uint32_t> ring(storage.data(), storage.size());
+
+  std::thread producer([&] {
+    std::uint32_t next = 0;
+    std::uint32_t chunk[13];
+    for (unsigned int round = 0; next < kCount; ++round) {
+      const std::uint32_t count =
+        std::min<std::uint32_t>(1 + round % 13, kCount - next);
+      for (std::uint32_t i = 0; i < count; ++i)
+        chunk[i] = next + i;
+      // Give the other side the CPU when the ring is full, as a single core
+      // host would otherwise spin out the whole time slice.
+      std::uint32_t done = 0;
+      while ((done += ring.write(chunk + done, count - done)) < count)
+        std::this_thread::yield();
+      next += count;
+    }
+  });
+
+  std::uint32_t expect = 0;
+  bool          ok     = true;
+  for (unsigned int round = 0; expect < kCount; ++round) {
+    // Alternate between copying out and reading in place.
+    if (round % 2) {
+      std::uint32_t     chunk[17];
+      const std::size_t n = ring.read(chunk, 1 + round % 17);
+      for (std::size_t i = 0; i < n; ++i)
+        ok &= chunk[i] == expect++;
+      if (!n)
+        std::this_thread::yield();
+    } else {
+      const std::uint32_t* span;
+      const std::size_t    n = ring.readSpan(span);
+      for (std::size_t i = 0; i < n; ++i)
+        ok &= span[i] == expect++;
+      ring.consume(n);
+      if (!n)
+        std::this_thread::yield();
+    }
+  }
+  producer.join();
+  RB_CHECK(ok);
+  RB_CHECK_EQ(ring.size(), 0);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  testWraparound_();
+  testSpans_();
+  testConcurrent_();
+  return rb::test::result();
+}
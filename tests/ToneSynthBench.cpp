@@ -0,0 +1,134 @@
+/// \file ToneSynthBench.cpp
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Benchmark of rb::ToneSynth, synthesizing the alarm pattern of
+/// audio_player.cpp a chunk at a time, the way a tone voice does.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include "Bench.hpp"
+#include "Check.hpp"
+#include "ToneSynth.hpp"
+
+// ======================= Local Definitions =========================
+
+namespace {
+
+/// \brief Rate of the tones, MUSIC_PLAYER_DEFAULT_PCM_RATE.
+constexpr int kRate = 24000;
+
+/// \brief Samples per chunk, kVoiceChunk of the MusicPlayer.
+constexpr int kChunk = 32;
+
+/// \brief Times the pattern is played per run.
+constexpr int kRepeats = 200;
+
+/// \brief Runs. The fastest one is reported.
+constexpr int kRuns = 5;
+
+/// \brief The alarm of audio_player.cpp: three short beeps and a rising sweep,
+/// played twice.
+const rb::Tone kAlarm[] = {
+  // start_hz, end_hz, duration_ms, attack_ms, release_ms, level
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {660, 1320, 400, 10, 60, 224},
+  {0, 0, 300, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {880, 880, 120, 5, 20, 224},
+  {0, 0, 80, 0, 0, 0},
+  {660, 1320, 400, 10, 60, 224},
+};
+
+/// \brief Play the alarm kRepeats times.
+///
+/// \param samples Set to the number of samples synthesized.
+///
+/// \return The sum of the samples.
+std::uint32_t
+playAlarm_(long& samples)
+{
+  rb::ToneSynth synth;
+  std::uint16_t buffer[kChunk];
+  std::uint32_t sum = 0;
+  samples           = 0;
+  for (int r = 0; r < kRepeats; ++r) {
+    for (const rb::Tone& tone : kAlarm) {
+      synth.start(tone, kRate);
+      while (const int n = synth.render(buffer, kChunk)) {
+        for (int i = 0; i < n; ++i)
+          sum += buffer[i];
+        samples += n;
+      }
+    }
+  }
+  return sum;
+}
+
+/// \brief Check that a steady tone has the right pitch, by counting upward
+/// zero crossings over a second.
+void
+checkPitch_()
+{
+  rb::ToneSynth synth;
+  synth.start({1000, 1000, 1000, 0, 0, 256}, kRate);
+  std::uint16_t buffer[kChunk];
+  long          samples   = 0;
+  int           crossings = 0;
+  bool          high      = false;
+  while (const int n = synth.render(buffer, kChunk)) {
+    for (int i = 0; i < n; ++i) {
+      const bool now = buffer[i] >= 0x8000;
+      crossings += now && !high;
+      high = now;
+    }
+    samples += n;
+  }
+  RB_CHECK_EQ(samples, kRate);
+  RB_CHECK(crossings >= 999 && crossings <= 1001);
+}
+
+} // namespace
+
+// ====================== Global Definitions =========================
+
+int
+main()
+{
+  checkPitch_();
+
+  long expect = 0;
+  for (const rb::Tone& tone : kAlarm)
+    expect += static_cast<long>(tone.duration_ms) * kRate / 1000;
+
+  double seconds = 1e30;
+  double cycles  = 1e30;
+  for (int r = 0; r < kRuns; ++r) {
+    long                samples;
+    const double        start       = rb::test::now();
+    const std::uint64_t start_cycle = rb::test::cycles();
+    rb::test::keep(playAlarm_(samples));
+    cycles  = std::min<double>(cycles, rb::test::cycles() - start_cycle);
+    seconds = std::min(seconds, rb::test::now() - start);
+    RB_CHECK_EQ(samples, expect * kRepeats);
+  }
+
+  const double samples = static_cast<double>(expect) * kRepeats;
+  std::printf("%16s %16s %16s\n", "samples/s", "cycles/sample", "x real time");
+  std::printf(
+    "%16.3g %16.2f %16.0f\n",
+    samples / seconds,
+    cycles / samples,
+    samples / seconds / kRate);
+  return rb::test::result();
+}
@@ -0,0 +1,66 @@
+/// \file BlockDevice.h
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Host stand-in for mbed's BlockDevice.h: the interface only, with
+/// the same names and defaults, so that block device adapters of src/ build
+/// on the host.
+
+#ifndef RB_TESTS_MBED_BLOCK_DEVICE_H
+#define RB_TESTS_MBED_BLOCK_DEVICE_H
+
+#ifndef __cplusplus
+#error "BlockDevice.h is a cxx-only header."
+#endif // __cplusplus
+
+#include <cstdint>
+
+// ======================= Public Interface ==========================
+
+namespace mbed {
+
+typedef std::uint64_t bd_addr_t;
+typedef std::uint64_t bd_size_t;
+
+// clang-format off
+enum
+{
+  BD_ERROR_OK           = 0
+, BD_ERROR_DEVICE_ERROR = -4001
+};
+// clang-format on
+
+/// \brief A device of blocks, read and programmed in multiples of its sizes.
+class BlockDevice
+{
+ public:
+  virtual ~BlockDevice() {}
+
+  virtual int init()   = 0;
+  virtual int deinit() = 0;
+  virtual int sync() { return 0; }
+  virtual int read(void* buffer, bd_addr_t addr, bd_size_t size) = 0;
+  virtual int program(const void* buffer, bd_addr_t addr, bd_size_t size) = 0;
+  virtual int erase(bd_addr_t, bd_size_t) { return 0; }
+  virtual int trim(bd_addr_t, bd_size_t) { return 0; }
+
+  virtual bd_size_t get_read_size() const    = 0;
+  virtual bd_size_t get_program_size() const = 0;
+  virtual bd_size_t get_erase_size() const { return get_program_size(); }
+  virtual bd_size_t get_erase_size(bd_addr_t) const
+  {
+    return get_erase_size();
+  }
+  virtual int         get_erase_value() const { return -1; }
+  virtual bd_size_t   size() const     = 0;
+  virtual const char* get_type() const = 0;
+};
+
+} // namespace mbed
+
+using mbed::bd_addr_t;
+using mbed::bd_size_t;
+using mbed::BD_ERROR_DEVICE_ERROR;
+using mbed::BD_ERROR_OK;
+
+#endif // RB_TESTS_MBED_BLOCK_DEVICE_H
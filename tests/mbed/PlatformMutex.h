@@ -0,0 +1,29 @@
+/// \file PlatformMutex.h
+/// \date 2026-10-16
+/// \author mshakula (matvey@gatech.edu)
+///
+/// \brief Host stand-in for mbed's PlatformMutex.h.
+
+#ifndef RB_TESTS_MBED_PLATFORM_MUTEX_H
+#define RB_TESTS_MBED_PLATFORM_MUTEX_H
+
+#ifndef __cplusplus
+#error "PlatformMutex.h is a cxx-only header."
+#endif // __cplusplus
+
+#include <mutex>
+
+// ======================= Public Interface ==========================
+
+/// \brief A recursive mutex, as PlatformMutex is under the RTOS.
+class PlatformMutex
+{
+ public:
+  void lock() { _mutex.lock(); }
+  void unlock() { _mutex.unlock(); }
+
+ private:
+  std::recursive_mutex _mutex;
+};
+
+#endif // RB_TESTS_MBED_PLATFORM_MUTEX_H
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# mkadpcmvector.py
+#
+# Write the IMA ADPCM test vector of AdpcmTest.cpp, from the reference codec of
+# CPython's audioop module (removed in Python 3.13, so run it with an earlier
+# one).
+#
+#   tests/mkadpcmvector.py > tests/AdpcmVector.hpp
+#
+# The signal is coded as two WAV blocks: a sine sweep, a full-scale square wave
+# to drive the predictor into clamping and the step index to its top, silence
+# to bring the index back down, and noise.
+
+import audioop
+import math
+import struct
+
+BLOCK = 128
+HEADER = 4
+SAMPLES = 1 + 2 * (BLOCK - HEADER)  # Per block.
+
+
+def signal(count):
+    samples = []
+    seed = 12345
+    for i in range(count):
+        if i < 200:
+            phase = 2 * math.pi * (0.01 * i + 0.0004 * i * i)
+            samples.append(int(12000 * math.sin(phase)))
+        elif i < 250:
+            samples.append(32767 if (i // 5) % 2 else -32768)
+        elif i < 350:
+            samples.append(0)
+        else:
+            seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+            samples.append((seed >> 8) % 20001 - 10000)
+    return samples
+
+
+def swap_nibbles(data):
+    # audioop puts the first sample of a byte in its high nibble, WAV in its low
+    # one.
+    return bytes(((b & 0xF) << 4) | (b >> 4) for b in data)
+
+
+def main():
+    x = signal(2 * SAMPLES)
+    coded = b""
+    decoded = []
+    index = 0
+    for block in range(2):
+        first = x[block * SAMPLES]
+        rest = x[block * SAMPLES + 1 : (block + 1) * SAMPLES]
+        pcm = struct.pack("<%dh" % len(rest), *rest)
+        nibbles, (_, next_index) = audioop.lin2adpcm(pcm, 2, (first, index))
+        out, _ = audioop.adpcm2lin(nibbles, 2, (first, index))
+        coded += struct.pack("<hBB", first, index, 0) + swap_nibbles(nibbles)
+        decoded += [first] + list(struct.unpack("<%dh" % (len(out) // 2), out))
+        index = next_index
+
+    print("/// \\file AdpcmVector.hpp")
+    print("///")
+    print("/// \\brief IMA ADPCM test vector, written by mkadpcmvector.py.")
+    print()
+    print("#ifndef RB_TESTS_ADPCM_VECTOR_HPP")
+    print("#define RB_TESTS_ADPCM_VECTOR_HPP")
+    print()
+    print("#include <cstdint>")
+    print()
+    print("/// \\brief Bytes per block.")
+    print("constexpr int kAdpcmBlock = %d;" % BLOCK)
+    print()
+    print("/// \\brief Two blocks of mono IMA ADPCM, as in a WAV data chunk.")
+    print("// clang-format off")
+    print("const std::uint8_t kAdpcmCoded[%d] = {" % len(coded))
+    for i in range(0, len(coded), 12):
+        print("  " + " ".join("0x%02x," % b for b in coded[i : i + 12]))
+    print("};")
+    print()
+    print("/// \\brief The blocks as decoded by the reference codec.")
+    print("const std::int16_t kAdpcmDecoded[%d] = {" % len(decoded))
+    for i in range(0, len(decoded), 8):
+        print("  " + " ".join("%6d," % s for s in decoded[i : i + 8]))
+    print("};")
+    print("// clang-format on")
+    print()
+    print("#endif // RB_TESTS_ADPCM_VECTOR_HPP")
+
+
+if __name__ == "__main__":
+    main()
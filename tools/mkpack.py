@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# mkpack.py
+#
+# Build a sound pack (see src/SoundPack.hpp) from a directory of clips.
+#
+# The pack is meant to be placed in the directory it was built from, e.g.
+#
+#   tools/mkpack.py sounds/ sounds/sounds.rbsp
+#
+# and then copied to SFX_DIR on the card together with (or instead of) the
+# clips themselves.
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"RBSP"
+VERSION = 1
+NAME_SIZE = 40
+HEADER = struct.Struct("<4sHHII")
+ENTRY = struct.Struct("<%dsII" % NAME_SIZE)
+
+
+def align_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def collect(root, exts, output):
+    clips = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in filenames:
+            path = os.path.join(dirpath, filename)
+            if os.path.abspath(path) == os.path.abspath(output):
+                continue
+            if exts and os.path.splitext(filename)[1].lower() not in exts:
+                continue
+            name = os.path.relpath(path, root).replace(os.sep, "/")
+            if len(name.encode()) >= NAME_SIZE:
+                sys.exit("mkpack: name too long: %s" % name)
+            clips.append((name.encode(), path))
+    # The player looks clips up by binary search over the raw names.
+    clips.sort()
+    return clips
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Build a sound pack from a directory of clips."
+    )
+    parser.add_argument("root", help="directory of clips to pack")
+    parser.add_argument("output", help="pack file to write")
+    parser.add_argument(
+        "--align",
+        type=int,
+        default=512,
+        help="payload alignment in bytes, a card sector by default",
+    )
+    parser.add_argument(
+        "--max-clip",
+        type=int,
+        default=12000,
+        help="largest clip the player caches in memory, in bytes, "
+        "MUSIC_PLAYER_CLIP_CACHE_MAX_CLIP by default",
+    )
+    parser.add_argument(
+        "--ext",
+        action="append",
+        default=[],
+        help="only pack files with this extension (repeatable)",
+    )
+    args = parser.parse_args()
+
+    if args.align <= 0 or args.align & (args.align - 1):
+        sys.exit("mkpack: alignment must be a power of two")
+    exts = {e.lower() if e.startswith(".") else "." + e.lower() for e in args.ext}
+
+    clips = collect(args.root, exts, args.output)
+    if len(clips) > 0xFFFF:
+        sys.exit("mkpack: too many clips")
+
+    offset = align_up(HEADER.size + ENTRY.size * len(clips), args.align)
+    index = []
+    for name, path in clips:
+        size = os.path.getsize(path)
+        index.append((name, offset, size))
+        offset = align_up(offset + size, args.align)
+    if offset > 0xFFFFFFFF:
+        sys.exit("mkpack: pack too large")
+
+    with open(args.output, "wb") as out:
+        out.write(HEADER.pack(MAGIC, VERSION, len(index), args.align, 0))
+        for name, offset, size in index:
+            out.write(ENTRY.pack(name, offset, size))
+        for (name, offset, size), (_, path) in zip(index, clips):
+            out.write(b"\0" * (offset - out.tell()))
+            with open(path, "rb") as clip:
+                out.write(clip.read())
+
+    # Clips marked with a * are small enough for the clip cache, the rest are
+    # streamed from the card on every play.
+    for name, offset, size in index:
+        cached = "*" if size <= args.max_clip else " "
+        print("%08x %8d %s %s" % (offset, size, cached, name.decode()))
+    cached = sum(1 for _, _, size in index if size <= args.max_clip)
+    print("%d of %d clips fit the clip cache" % (cached, len(index)))
+
+
+if __name__ == "__main__":
+    main()